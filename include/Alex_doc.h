@@ -0,0 +1,71 @@
+#ifndef DOC_H
+#define DOC_H
+
+#include <pthread.h>
+#include <sys/uio.h>
+
+#include "Alex_textbuf.h"
+
+
+// Lines between recorded offsets in the original's line index
+#define DOC_MARK_STRIDE 64
+
+
+// Read-only original content with a line index built in the background
+// Only every DOC_MARK_STRIDE'th line start is stored, others are found by scanning
+typedef struct {
+    const char* data;
+    size_t size;
+    size_t* marks; // marks[i] is start of line i * DOC_MARK_STRIDE
+    size_t lines_ready; // Lines whose start is indexed, published by scanner
+    int done; // Set by scanner once every line is indexed
+    int stop; // Asks scanner to exit early
+    pthread_t scanner;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t last_line, last_start; // Most recent lookup, speeds up nearby lines
+} DocOrig;
+
+
+// Run of whole lines, either untouched original lines or edited text
+// Edited spans hold their lines in a TextBuf, each line ending in '\n'
+typedef struct {
+    int edited;
+    size_t first; // Original: first line
+    size_t count; // Original: number of lines, DOC_TO_END for rest of file
+    TextBuf* tb; // Edited: text of lines
+} DocSpan;
+
+#define DOC_TO_END ((size_t)-1)
+
+
+// Document shown by the editor
+// Original lines are materialized into edited spans only when changed
+typedef struct {
+    DocOrig orig;
+    int has_orig;
+    DocSpan* spans;
+    size_t num_spans, cap_spans;
+} Doc;
+
+
+// Lifetime
+int docInit(Doc* doc);
+int docOpen(Doc* doc, const char* data, size_t size);
+void docFree(Doc* doc);
+
+// Queries
+size_t docLineCount(Doc* doc);
+int docIndexDone(Doc* doc);
+void docWaitLines(Doc* doc, size_t n);
+size_t docLineLength(Doc* doc, size_t y);
+size_t docCopyLine(Doc* doc, size_t y, size_t x, size_t n, char* out);
+struct iovec* docChunks(Doc* doc, int* count);
+int docFind(Doc* doc, size_t y, size_t x, const char* needle, size_t m, size_t* fy, size_t* fx);
+
+// Edits
+int docInsert(Doc* doc, size_t y, size_t x, const char* s, size_t n);
+int docDelete(Doc* doc, size_t y, size_t x, size_t n);
+
+
+#endif
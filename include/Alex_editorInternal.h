@@ -0,0 +1,12 @@
+#ifndef EDITOR_INTERNAL_H
+#define EDITOR_INTERNAL_H
+
+
+// Text buffer operations used by the editor and its benchmarks
+// Not part of the editor interface used by xfile
+void editorBufferInit();
+void process_key(int k);
+char* get_full_text();
+
+
+#endif
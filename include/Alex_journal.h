@@ -0,0 +1,55 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "Alex_libFS2025.h"
+
+
+// Recovery journal config
+#define JOURNAL_DIR ".fsrecovery/" // Path from project root to where journals are kept
+#define JOURNAL_INTERVAL_MS 1000 // Longest time an edit waits before reaching disk
+#define JOURNAL_PATH_SIZE (sizeof(JOURNAL_DIR) + MAX_FILENAME + sizeof(".journal"))
+
+
+// Recorded edit operations
+enum {
+    JOURNAL_INSERT = 1, // Bytes inserted at line and column
+    JOURNAL_DELETE = 2  // Byte count deleted at line and column
+};
+
+
+// Applies one recovered edit, 's' holds inserted bytes
+typedef void (*JournalApply)(int op, size_t y, size_t x, const char* s, size_t n);
+
+
+// Edits of one editor session, written to disk by a background thread
+// Editing thread only appends records to memory
+typedef struct {
+    char path[JOURNAL_PATH_SIZE];
+    int active; // Set while recording
+    int stop; // Asks writer to flush and exit
+    int failed; // Set once journal cannot be written, recording stops
+    const char* base; // Content edits apply to
+    size_t base_size;
+    int64_t base_mtime; // Modification time of base content in nanoseconds
+    size_t keep; // Bytes of existing journal to continue from, zero to start anew
+    char* pending; // Records not yet handed to writer
+    size_t len, cap;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} Journal;
+
+
+// Recovery
+size_t journalReplay(const char* filename, const char* base, size_t size, int64_t mtime, JournalApply apply, size_t* edits);
+
+// Recording
+int journalStart(Journal* j, const char* filename, const char* base, size_t size, int64_t mtime, size_t keep);
+void journalRecord(Journal* j, int op, size_t y, size_t x, const char* s, size_t n);
+void journalStop(Journal* j, int discard);
+
+
+#endif
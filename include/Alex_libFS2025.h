@@ -1,9 +1,11 @@
 #ifndef LIBFS2025_H
 #define LIBFS2025_H
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 
 
 // Constants
@@ -13,6 +15,21 @@
 #define LIBFS_ERR -1
 
 
+// Error codes reported by libfsLastError after a call returns LIBFS_ERR
+typedef enum {
+    LIBFS_OK = 0,
+    LIBFS_ENOENT,  // File does not exist
+    LIBFS_EEXIST,  // File already exists
+    LIBFS_EBADF,   // Descriptor does not point to valid file
+    LIBFS_ECLOSED, // File is not open
+    LIBFS_EOPEN,   // File is already open
+    LIBFS_ENOSPC,  // File table is full
+    LIBFS_EINVAL,  // Invalid argument such as an overlong name
+    LIBFS_ERANGE,  // Buffer too small for file data
+    LIBFS_EIO      // Host file system operation failed
+} LibFSError;
+
+
 // File system structures
 typedef struct {
     char filename[MAX_FILENAME];
@@ -26,11 +43,19 @@ typedef struct {
 int fileCreate(const char *filename);
 int fileOpen(const char *filename);
 int fileWrite(int file_index, const char *data);
+int fileWritev(int file_index, const struct iovec *iov, int iovcnt);
 int fileRead(int file_index, char *buffer, int buffer_size);
+int fileMap(int file_index, const char **data, size_t *size);
+int fileUnmap(const char *data, size_t size);
+int fileModTime(int file_index, int64_t *mtime_ns);
 int fileClose(int file_index);
 int fileDelete(const char *filename);
 FileEntry** fileList(size_t* num_files);
 int libFSLoad();
 
+// Error reporting
+int libfsLastError(void);
+const char* libfsStrerror(int err);
+
 
 #endif // LIBFS2025_H
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef LIBFS_CLIENT_H
+#define LIBFS_CLIENT_H
+
+#include "Alex_libFS2025.h"
+#include "Alex_libFSProto.h"
+
+
+// Connection to a libfsd server
+typedef struct FSClient FSClient;
+
+
+// Connection management
+FSClient* fsClientConnect(const char* sock_path);
+void fsClientDisconnect(FSClient* client);
+
+
+// Blocking calls mirroring libFS2025
+// Must not be mixed with unanswered pipelined requests
+int fsClientCreate(FSClient* client, const char* filename);
+int fsClientOpen(FSClient* client, const char* filename);
+int fsClientWrite(FSClient* client, int file_index, const char* data);
+int fsClientRead(FSClient* client, int file_index, char* buffer, int buffer_size);
+int fsClientClose(FSClient* client, int file_index);
+int fsClientDelete(FSClient* client, const char* filename);
+FileEntry* fsClientList(FSClient* client, size_t* num_files);
+int fsClientLastError(FSClient* client);
+
+
+// Pipelining interface
+// Requests are queued by fsClientSend and transmitted by fsClientFlush
+// Responses arriving during a flush are buffered, so pipelines of any size are safe
+// Responses arrive in request order through fsClientRecv
+uint32_t fsClientSend(FSClient* client, uint16_t op, int32_t arg, int32_t arg2, const void* payload, uint32_t len);
+int fsClientFlush(FSClient* client);
+int fsClientRecv(FSClient* client, FSPHeader* rsp, const char** payload);
+
+
+#endif // LIBFS_CLIENT_H
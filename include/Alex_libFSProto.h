@@ -0,0 +1,48 @@
+#ifndef LIBFS_PROTO_H
+#define LIBFS_PROTO_H
+
+#include <stdint.h>
+
+
+// Wire protocol shared by libfsd and the libFS client library
+// Frames are a fixed header followed by 'len' bytes of payload
+// Host byte order is used since both ends share a Unix domain socket
+
+
+// Default socket path, relative to project root
+#define LIBFSD_SOCK_PATH ".libfsd.sock"
+
+// Largest payload accepted in a single frame
+#define FSP_MAX_PAYLOAD (64u << 20)
+
+
+// Operation codes, one per libFS entry point
+enum {
+    FSP_CREATE = 1, // payload: filename
+    FSP_OPEN,       // payload: filename
+    FSP_READ,       // arg: descriptor, arg2: buffer size
+    FSP_WRITE,      // arg: descriptor, payload: data
+    FSP_CLOSE,      // arg: descriptor
+    FSP_DELETE,     // payload: filename
+    FSP_LIST        // response payload: FSPListEntry records
+};
+
+
+// Frame header for both requests and responses
+// Responses echo 'id' and 'op' of the request they answer
+typedef struct {
+    uint32_t len;   // Payload bytes following header
+    uint32_t id;    // Request id chosen by client
+    uint16_t op;    // FSP_* operation code
+    uint16_t flags; // Reserved, must be zero
+    int32_t arg;    // Request: descriptor. Response: libFS return value
+    int32_t arg2;   // Request: read size. Response: LibFSError code
+} FSPHeader;
+
+
+// List response payload is a sequence of records laid out as:
+//   uint32_t size, uint8_t name_len, char name[name_len]
+#define FSP_LIST_REC_MIN 5
+
+
+#endif // LIBFS_PROTO_H
@@ -0,0 +1,56 @@
+#ifndef LIBFS_STATS_H
+#define LIBFS_STATS_H
+
+#include <stdint.h>
+
+
+// Number of log2 latency buckets
+// Bucket i counts calls taking [2^i, 2^(i+1)) nanoseconds
+#define LIBFS_HIST_BUCKETS 40
+
+
+// Public entry points tracked by libfsStats
+typedef enum {
+    LIBFS_OP_CREATE,
+    LIBFS_OP_OPEN,
+    LIBFS_OP_WRITE,
+    LIBFS_OP_READ,
+    LIBFS_OP_CLOSE,
+    LIBFS_OP_DELETE,
+    LIBFS_OP_LIST,
+    LIBFS_OP_LOAD,
+    LIBFS_OP_MAP,
+    LIBFS_OP_STAT,
+    LIBFS_OP_COUNT
+} LibFSOp;
+
+
+// Counters for a single operation
+typedef struct {
+    uint64_t calls; // Completed calls including failures
+    uint64_t errors; // Calls returning LIBFS_ERR
+    uint64_t bytes; // Bytes moved by reads and writes
+    uint64_t total_ns; // Sum of call latencies
+    uint64_t max_ns; // Slowest single call
+    uint64_t hist[LIBFS_HIST_BUCKETS]; // Latency histogram
+} LibFSOpStats;
+
+
+// Snapshot of counters summed across all threads
+typedef struct {
+    LibFSOpStats ops[LIBFS_OP_COUNT];
+} LibFSStats;
+
+
+// Metrics interface
+void libfsStats(LibFSStats* out);
+uint64_t libfsStatsPercentile(const LibFSOpStats* op, double q);
+const char* libfsOpName(int op);
+
+
+// Instrumentation hooks used by libFS entry points
+uint64_t libfsStatsStart(void);
+int libfsStatsRecord(int op, uint64_t start, int ret);
+
+
+#endif // LIBFS_STATS_H
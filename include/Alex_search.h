@@ -0,0 +1,39 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stddef.h>
+
+#include "Alex_libFS2025.h"
+
+
+// Cross-file search config
+#define SEARCH_MAX_HITS 5 // Match positions kept per file
+#define SEARCH_EXCERPT 64 // Bytes of printable excerpt kept per position
+#define SEARCH_MAX_THREADS 16 // Upper bound on search threads, including caller
+
+
+// Position of one match
+typedef struct {
+    size_t line, col; // Both counted from one
+    char text[SEARCH_EXCERPT]; // Start of matching line, control bytes escaped, terminated
+} SearchHit;
+
+
+// Matches found in one file
+typedef struct {
+    char filename[MAX_FILENAME];
+    size_t matches; // Non-overlapping matches in whole file
+    size_t num_hits; // Positions kept, first SEARCH_MAX_HITS matches
+    SearchHit hits[SEARCH_MAX_HITS];
+    int error; // LibFSError if file could not be searched, else LIBFS_OK
+} SearchResult;
+
+
+// Substring search
+const char* searchFind(const char* hay, size_t n, const char* needle, size_t m);
+
+// Search every libFS file
+SearchResult* searchFiles(const char* pattern, size_t* num_results);
+
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TEXTBUF_H
+#define TEXTBUF_H
+
+#include <stddef.h>
+
+
+// Gap buffer holding editor text with an incremental line index
+// Positions are byte offsets into the text, lines are split on '\n'
+//
+// The line index is itself a gap array kept at the same place as the text gap.
+// Lines starting at or before the gap store their absolute start, lines after
+// it store their distance from the end of the text. Edits at the gap therefore
+// leave every stored entry valid, so inserts and deletes at the cursor are
+// amortized O(1) however long the text is.
+typedef struct {
+    char* text; // Text bytes, gap at [gap_start, gap_end)
+    size_t cap;
+    size_t gap_start, gap_end;
+    size_t* lines; // Line index, gap at [lgap_start, lgap_end)
+    size_t lcap;
+    size_t lgap_start, lgap_end;
+} TextBuf;
+
+
+// Lifetime
+int tbInit(TextBuf* tb);
+void tbFree(TextBuf* tb);
+
+// Queries
+size_t tbLength(const TextBuf* tb);
+size_t tbLineCount(const TextBuf* tb);
+size_t tbLineStart(const TextBuf* tb, size_t y);
+size_t tbLineLength(const TextBuf* tb, size_t y);
+size_t tbCopy(const TextBuf* tb, size_t pos, size_t n, char* out);
+void tbSegments(const TextBuf* tb, const char** a, size_t* a_len, const char** b, size_t* b_len);
+
+// Edits
+int tbInsert(TextBuf* tb, size_t pos, const char* s, size_t n);
+void tbDelete(TextBuf* tb, size_t pos, size_t n);
+
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef UNDO_H
+#define UNDO_H
+
+#include <stddef.h>
+
+
+// History size cap in bytes
+// May be overridden at build time, or per history with undoSetCap
+#ifndef UNDO_MAX_BYTES
+#define UNDO_MAX_BYTES (16u << 20)
+#endif
+
+// Longest run of typed characters merged into one record
+#define UNDO_RUN_MAX 256
+
+
+// Recorded edit operations
+enum {
+    UNDO_INSERT = 1, // Bytes inserted at line and column
+    UNDO_DELETE = 2  // Bytes deleted at line and column
+};
+
+
+// Applies one edit of an undo or redo step, 's' holds the bytes involved
+typedef void (*UndoApply)(int op, size_t y, size_t x, const char* s, size_t n);
+
+
+// Edit history
+// Records live back to back in one arena, oldest first
+// Records from 'cur' onward are undone edits available to redo
+typedef struct {
+    char* arena;
+    size_t len, cap;
+    size_t* recs; // Arena offset of each record
+    size_t count, rcap;
+    size_t cur; // Records before this are applied
+    size_t max_bytes; // Cap on arena plus record offsets
+    int open; // Set while last record may absorb the next edit
+} UndoLog;
+
+
+// Lifetime
+void undoInit(UndoLog* u);
+void undoFree(UndoLog* u);
+void undoSetCap(UndoLog* u, size_t max_bytes);
+
+// Recording
+void undoRecord(UndoLog* u, int op, size_t y, size_t x, const char* s, size_t n);
+void undoBreak(UndoLog* u);
+
+// Stepping
+int undoStep(UndoLog* u, UndoApply apply);
+int redoStep(UndoLog* u, UndoApply apply);
+
+
+#endif
@@ -0,0 +1,484 @@
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "../include/Alex_libFS2025.h"
+#include "../include/Alex_editor.h"
+#include "../include/Alex_editorInternal.h"
+#include "../include/Alex_search.h"
+
+
+// Benchmark file store, compiled into libFS for this binary
+#ifndef LIBFS_BASE_DIR
+#define LIBFS_BASE_DIR ".fsdata/"
+#endif
+
+#define BENCH_PREFIX "bench_"
+#define EDITOR_LINE_LEN 64 // Characters per line when filling editor buffer
+
+
+// Scales exercised by the full run
+// File counts beyond MAX_FILES are skipped and reported as such
+static const int file_scales[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+static const size_t payload_sizes[] = { 16, 256, 4096, 65536, 1 << 20, 16 << 20, 64 << 20 };
+static const int line_scales[] = { 1000, 10000, 100000, 1000000 };
+static const size_t search_sizes[] = { 65536, 1 << 20, 64 << 20 };
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+
+// Latency samples for the benchmark currently running
+typedef struct {
+    uint64_t* ns;
+    size_t len, cap;
+    uint64_t total_ns; // Wall time covered by samples
+} Samples;
+
+
+int quick = 0; // Reduced iteration counts for smoke runs
+int results_emitted = 0; // Number of JSON result objects written
+
+
+// Returns monotonic time in nanoseconds
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+
+// Appends one latency sample
+static void addSample(Samples* s, uint64_t ns) {
+    if(s->len == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 1024;
+        s->ns = realloc(s->ns, s->cap * sizeof(uint64_t));
+
+        if(!s->ns) {
+            fprintf(stderr, "bench: out of memory\n");
+            exit(1);
+        }
+    }
+
+    s->ns[s->len++] = ns;
+    s->total_ns += ns;
+}
+
+
+// Orders samples for percentile lookup
+static int cmpU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+// Returns sample at quantile 'q' of sorted samples
+static uint64_t percentile(const Samples* s, double q) {
+    size_t idx = q * (s->len - 1) + 0.5;
+    return s->ns[idx];
+}
+
+
+// Writes result for one benchmark as JSON object and resets samples
+// 'params' is a preformatted JSON object body
+static void emitResult(const char* name, const char* params, Samples* s, uint64_t bytes_per_op) {
+    if(s->len == 0)
+        return;
+
+    qsort(s->ns, s->len, sizeof(uint64_t), cmpU64);
+
+    double secs = s->total_ns / 1e9;
+    double ops_per_sec = secs > 0 ? s->len / secs : 0;
+
+    printf("%s\n    {\"name\": \"%s\", \"params\": {%s}, \"ops\": %zu, \"ops_per_sec\": %.1f, "
+           "\"bytes_per_sec\": %.1f, \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}",
+           results_emitted++ ? "," : "",
+           name, params, s->len, ops_per_sec, ops_per_sec * bytes_per_op,
+           (unsigned long long)percentile(s, 0.50),
+           (unsigned long long)percentile(s, 0.90),
+           (unsigned long long)percentile(s, 0.99),
+           (unsigned long long)s->ns[s->len - 1]);
+    fflush(stdout);
+
+    fprintf(stderr, "bench: %-16s {%s} %.0f ops/s\n", name, params, ops_per_sec);
+
+    s->len = 0;
+    s->total_ns = 0;
+}
+
+
+// Writes failed benchmark as JSON object with error 'err' instead of timings
+// Discards samples taken before the failure
+static void emitError(const char* name, const char* params, Samples* s, const char* err) {
+    printf("%s\n    {\"name\": \"%s\", \"params\": {%s}, \"error\": \"%s\"}",
+           results_emitted++ ? "," : "", name, params, err);
+    fflush(stdout);
+
+    fprintf(stderr, "bench: %-16s {%s} failed: %s\n", name, params, err);
+
+    s->len = 0;
+    s->total_ns = 0;
+}
+
+
+// Builds benchmark file name for index 'i'
+static void benchName(char* out, int i) {
+    snprintf(out, MAX_FILENAME, BENCH_PREFIX "%07d", i);
+}
+
+
+// Removes files left by an interrupted earlier run
+static void removeStaleFiles() {
+    size_t num_files = 0;
+    FileEntry** files = fileList(&num_files);
+
+    // Collect names first since deleting mutates the table
+    char (*names)[MAX_FILENAME] = malloc((num_files ? num_files : 1) * MAX_FILENAME);
+    size_t stale = 0;
+
+    for(size_t i = 0; i < num_files; i++) {
+        if(strncmp(files[i]->filename, BENCH_PREFIX, strlen(BENCH_PREFIX)) == 0)
+            strcpy(names[stale++], files[i]->filename);
+    }
+
+    for(size_t i = 0; i < stale; i++)
+        fileDelete(names[i]);
+
+    free(names);
+    free(files);
+}
+
+
+// Deletes first 'n' benchmark files
+static void deleteFiles(int n) {
+    char name[MAX_FILENAME];
+
+    for(int i = 0; i < n; i++) {
+        benchName(name, i);
+        fileDelete(name);
+    }
+}
+
+
+// Benchmarks create, open, close, list and delete with 'n' files present
+// A failing call ends the benchmark with an error result, remaining steps are skipped
+static void benchFileScale(int n, Samples* s) {
+    char params[64], name[MAX_FILENAME];
+    snprintf(params, sizeof(params), "\"files\": %d", n);
+
+    // Create
+    for(int i = 0; i < n; i++) {
+        benchName(name, i);
+        uint64_t t = nowNs();
+        int ret = fileCreate(name);
+        addSample(s, nowNs() - t);
+
+        if(ret == LIBFS_ERR) {
+            emitError("libfs.create", params, s, libfsStrerror(libfsLastError()));
+            deleteFiles(i);
+            return;
+        }
+    }
+    emitResult("libfs.create", params, s, 0);
+
+    // Open and close every file, lookups get slower as table fills
+    int* fds = malloc(n * sizeof(int));
+    if(!fds) {
+        fprintf(stderr, "bench: out of memory\n");
+        exit(1);
+    }
+
+    for(int i = 0; i < n; i++) {
+        benchName(name, i);
+        uint64_t t = nowNs();
+        fds[i] = fileOpen(name);
+        addSample(s, nowNs() - t);
+
+        if(fds[i] == LIBFS_ERR) {
+            emitError("libfs.open", params, s, libfsStrerror(libfsLastError()));
+            for(int j = 0; j < i; j++)
+                fileClose(fds[j]);
+            free(fds);
+            deleteFiles(n);
+            return;
+        }
+    }
+    emitResult("libfs.open", params, s, 0);
+
+    for(int i = 0; i < n; i++) {
+        uint64_t t = nowNs();
+        int ret = fileClose(fds[i]);
+        addSample(s, nowNs() - t);
+
+        if(ret == LIBFS_ERR) {
+            emitError("libfs.close", params, s, libfsStrerror(libfsLastError()));
+            for(int j = i + 1; j < n; j++)
+                fileClose(fds[j]);
+            free(fds);
+            deleteFiles(n);
+            return;
+        }
+    }
+    emitResult("libfs.close", params, s, 0);
+    free(fds);
+
+    // List whole table repeatedly
+    int list_iters = quick ? 10 : 1000;
+    for(int i = 0; i < list_iters; i++) {
+        size_t num_files;
+        uint64_t t = nowNs();
+        FileEntry** files = fileList(&num_files);
+        addSample(s, nowNs() - t);
+
+        if(!files) {
+            emitError("libfs.list", params, s, libfsStrerror(libfsLastError()));
+            deleteFiles(n);
+            return;
+        }
+        free(files);
+    }
+    emitResult("libfs.list", params, s, 0);
+
+    // Delete
+    for(int i = 0; i < n; i++) {
+        benchName(name, i);
+        uint64_t t = nowNs();
+        int ret = fileDelete(name);
+        addSample(s, nowNs() - t);
+
+        if(ret == LIBFS_ERR) {
+            emitError("libfs.delete", params, s, libfsStrerror(libfsLastError()));
+            deleteFiles(n); // Remove whatever is left
+            return;
+        }
+    }
+    emitResult("libfs.delete", params, s, 0);
+}
+
+
+// Benchmarks write and read of a single file holding 'size' bytes
+// Failures end the benchmark with an error result instead of timing error returns
+static void benchPayload(size_t size, Samples* s) {
+    char params[64], name[MAX_FILENAME];
+    snprintf(params, sizeof(params), "\"payload_bytes\": %zu", size);
+    benchName(name, 0);
+
+    // fileWrite takes a terminated string
+    char* data = malloc(size + 1);
+    char* buffer = malloc(size);
+    if(!data || !buffer) {
+        fprintf(stderr, "bench: cannot allocate %zu byte payload\n", size);
+        free(data);
+        free(buffer);
+        return;
+    }
+
+    memset(data, 'a', size);
+    data[size] = '\0';
+
+    // Move about 256 MiB per benchmark, bounded for tiny payloads
+    size_t iters = (256u << 20) / size;
+    if(iters < 3) iters = 3;
+    if(iters > 2000) iters = 2000;
+    if(quick) iters = iters > 5 ? 5 : iters;
+
+    if(fileCreate(name) == LIBFS_ERR) {
+        emitError("libfs.write", params, s, libfsStrerror(libfsLastError()));
+        free(data);
+        free(buffer);
+        return;
+    }
+
+    int fd = fileOpen(name);
+    int failed = fd == LIBFS_ERR;
+
+    if(failed)
+        emitError("libfs.write", params, s, libfsStrerror(libfsLastError()));
+
+    for(size_t i = 0; i < iters && !failed; i++) {
+        uint64_t t = nowNs();
+        int ret = fileWrite(fd, data);
+        addSample(s, nowNs() - t);
+
+        if(ret == LIBFS_ERR) {
+            emitError("libfs.write", params, s, libfsStrerror(libfsLastError()));
+            failed = 1;
+        }
+    }
+
+    if(!failed)
+        emitResult("libfs.write", params, s, size);
+
+    // Reads need the written payload
+    for(size_t i = 0; i < iters && !failed; i++) {
+        uint64_t t = nowNs();
+        int ret = fileRead(fd, buffer, size);
+        addSample(s, nowNs() - t);
+
+        if(ret == LIBFS_ERR) {
+            emitError("libfs.read", params, s, libfsStrerror(libfsLastError()));
+            failed = 1;
+        }
+    }
+
+    if(!failed)
+        emitResult("libfs.read", params, s, size);
+
+    if(fd != LIBFS_ERR)
+        fileClose(fd);
+    fileDelete(name);
+    free(data);
+    free(buffer);
+}
+
+
+// Types one line of text followed by enter
+static void typeLine() {
+    for(int c = 0; c < EDITOR_LINE_LEN; c++)
+        process_key('a' + c % 26);
+    process_key('\r');
+}
+
+
+// Benchmarks editor buffer operations at 'lines' lines of text
+static void benchEditor(int lines, Samples* s) {
+    char params[64];
+    snprintf(params, sizeof(params), "\"lines\": %d", lines);
+
+    // Keystrokes appended to a single line of the same length
+    char insert_params[64];
+    snprintf(insert_params, sizeof(insert_params), "\"line_len\": %d", lines);
+
+    editorBufferInit();
+    for(int i = 0; i < lines; i++) {
+        uint64_t t = nowNs();
+        process_key('a' + i % 26);
+        addSample(s, nowNs() - t);
+    }
+    emitResult("editor.insert", insert_params, s, 1);
+
+    // Enter pressed on the first line, shifting every line below
+    editorBufferInit();
+    for(int i = 0; i < lines - 1; i++) {
+        uint64_t t = nowNs();
+        process_key('\r');
+        addSample(s, nowNs() - t);
+        process_key('U'); // Return to first line
+    }
+    emitResult("editor.newline", params, s, 0);
+
+    // Export full text of a filled buffer
+    editorBufferInit();
+    for(int i = 0; i < lines - 1; i++)
+        typeLine();
+
+    int export_iters = quick ? 3 : 50;
+    size_t text_len = 0;
+    for(int i = 0; i < export_iters; i++) {
+        uint64_t t = nowNs();
+        char* text = get_full_text();
+        addSample(s, nowNs() - t);
+
+        if(!text) { // Export could not allocate buffer copy
+            emitError("editor.export", params, s, "Out of memory");
+            return;
+        }
+
+        text_len = strlen(text);
+        free(text);
+    }
+    emitResult("editor.export", params, s, text_len);
+}
+
+
+// Benchmarks substring search over 'size' bytes of text
+// Pattern is absent so every byte is scanned
+static void benchSearch(size_t size, Samples* s) {
+    static const char letters[] = " etaoinshrdlu\n";
+    static const char pattern[] = "xylophone";
+
+    char* text = malloc(size);
+    if(!text)
+        return;
+
+    uint64_t x = 88172645463325252ull; // Fixed xorshift seed, same text every run
+    for(size_t i = 0; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        text[i] = letters[x % (sizeof(letters) - 1)];
+    }
+
+    char params[64];
+    snprintf(params, sizeof(params), "\"size\": %zu", size);
+
+    int iters = quick ? 3 : 20;
+    for(int i = 0; i < iters; i++) {
+        uint64_t t = nowNs();
+        const char* found = searchFind(text, size, pattern, sizeof(pattern) - 1);
+        addSample(s, nowNs() - t);
+
+        if(found) // Keeps the call from being optimized away
+            fprintf(stderr, "bench: unexpected match\n");
+    }
+    emitResult("search.scan", params, s, size);
+
+    free(text);
+}
+
+
+// Run libFS and editor microbenchmarks
+// Results written to stdout as JSON, progress to stderr
+// Pass --quick for a short smoke run
+int main(int argc, char** argv) {
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--quick") == 0)
+            quick = 1;
+        else {
+            fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Benchmark store is separate from user files
+    if(mkdir(LIBFS_BASE_DIR, 0755) == -1 && errno != EEXIST) {
+        perror("bench: mkdir " LIBFS_BASE_DIR);
+        return 1;
+    }
+
+    if(libFSLoad() == LIBFS_ERR) {
+        fprintf(stderr, "bench: %s\n", libfsStrerror(libfsLastError()));
+        return 1;
+    }
+
+    removeStaleFiles();
+
+    printf("{\n  \"max_files\": %d,\n  \"quick\": %s,\n  \"results\": [", MAX_FILES, quick ? "true" : "false");
+
+    Samples s = { 0 };
+
+    for(size_t i = 0; i < COUNT(file_scales); i++) {
+        if(file_scales[i] > MAX_FILES) {
+            fprintf(stderr, "bench: skipping %d files, table holds %d\n", file_scales[i], MAX_FILES);
+            continue;
+        }
+        benchFileScale(file_scales[i], &s);
+    }
+
+    for(size_t i = 0; i < COUNT(payload_sizes); i++)
+        benchPayload(payload_sizes[i], &s);
+
+    for(size_t i = 0; i < COUNT(line_scales); i++) {
+        if(quick && line_scales[i] > 10000)
+            break;
+        benchEditor(line_scales[i], &s);
+    }
+
+    for(size_t i = 0; i < COUNT(search_sizes); i++)
+        benchSearch(search_sizes[i], &s);
+
+    printf("\n  ]\n}\n");
+
+    free(s.ns);
+    return 0;
+}
@@ -0,0 +1,662 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/Alex_doc.h"
+#include "../include/Alex_search.h"
+
+
+#define PUBLISH_EVERY 16384 // Lines indexed between wakeups of waiting readers
+
+
+// Atomic access to fields shared with the scanner thread
+#define READY(o) __atomic_load_n(&(o)->lines_ready, __ATOMIC_ACQUIRE)
+#define DONE(o) __atomic_load_n(&(o)->done, __ATOMIC_ACQUIRE)
+
+
+// Publishes number of indexed lines and wakes waiting readers
+static void publishLines(DocOrig* o, size_t lines, int done) {
+    pthread_mutex_lock(&o->lock);
+    __atomic_store_n(&o->lines_ready, lines, __ATOMIC_RELEASE);
+    __atomic_store_n(&o->done, done, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&o->cond);
+    pthread_mutex_unlock(&o->lock);
+}
+
+
+// Scanner thread body
+// Records start of every DOC_MARK_STRIDE'th line of the original
+static void* scanLines(void* arg) {
+    DocOrig* o = arg;
+    const char* end = o->data + o->size;
+    const char* p = o->data;
+
+    o->marks[0] = 0; // Non-empty original always has a first line
+    size_t lines = 1;
+
+    while(!__atomic_load_n(&o->stop, __ATOMIC_RELAXED)) {
+        const char* nl = memchr(p, '\n', end - p);
+        if(!nl || nl + 1 == end) // Trailing newline does not begin a line
+            break;
+
+        p = nl + 1;
+        if(lines % DOC_MARK_STRIDE == 0)
+            o->marks[lines / DOC_MARK_STRIDE] = p - o->data;
+        lines++;
+
+        if(lines % PUBLISH_EVERY == 0)
+            publishLines(o, lines, 0);
+    }
+
+    publishLines(o, lines, 1);
+    return NULL;
+}
+
+
+// Blocks until more than 'seen' lines are indexed or scanning is done
+static void origWaitMore(DocOrig* o, size_t seen) {
+    if(READY(o) > seen || DONE(o))
+        return;
+
+    pthread_mutex_lock(&o->lock);
+    while(o->lines_ready <= seen && !o->done)
+        pthread_cond_wait(&o->cond, &o->lock);
+    pthread_mutex_unlock(&o->lock);
+}
+
+
+// Blocks until original line 'k' is indexed or scanning is done
+static void origWaitLine(DocOrig* o, size_t k) {
+    while(READY(o) <= k && !DONE(o))
+        origWaitMore(o, READY(o));
+}
+
+
+// Returns offset of first byte of original line 'k'
+// Line must already be indexed, returns size past the last line
+static size_t origLineStart(DocOrig* o, size_t k) {
+    if(k >= READY(o)) // Past last line
+        return o->size;
+
+    // Walk forward from cached lookup when close, else from nearest mark
+    size_t line, off;
+    if(k >= o->last_line && k - o->last_line < DOC_MARK_STRIDE) {
+        line = o->last_line;
+        off = o->last_start;
+    }
+    else {
+        line = k / DOC_MARK_STRIDE * DOC_MARK_STRIDE;
+        off = o->marks[k / DOC_MARK_STRIDE];
+    }
+
+    while(line < k) {
+        const char* nl = memchr(o->data + off, '\n', o->size - off);
+        off = nl - o->data + 1;
+        line++;
+    }
+
+    o->last_line = k;
+    o->last_start = off;
+    return off;
+}
+
+
+// Returns offset just past line content starting at 'start', excluding '\n'
+static size_t origLineEnd(DocOrig* o, size_t start) {
+    const char* nl = memchr(o->data + start, '\n', o->size - start);
+    return nl ? (size_t)(nl - o->data) : o->size;
+}
+
+
+// Returns number of lines in a span
+// Open-ended original spans count only lines indexed so far
+static size_t spanLines(Doc* doc, DocSpan* s) {
+    if(s->edited)
+        return tbLineCount(s->tb) - 1; // Final '\n' ends the last line
+
+    if(s->count != DOC_TO_END)
+        return s->count;
+
+    size_t ready = READY(&doc->orig);
+    return ready > s->first ? ready - s->first : 0;
+}
+
+
+// Replaces 'remove' spans at 'at' with 'n' new spans
+// Returns zero on allocation failure
+static int spliceSpans(Doc* doc, size_t at, size_t remove, const DocSpan* add, size_t n) {
+    size_t new_count = doc->num_spans - remove + n;
+
+    if(new_count > doc->cap_spans) {
+        size_t cap = doc->cap_spans ? doc->cap_spans * 2 : 8;
+        while(cap < new_count)
+            cap *= 2;
+
+        DocSpan* grown = realloc(doc->spans, cap * sizeof(DocSpan));
+        if(!grown)
+            return 0;
+
+        doc->spans = grown;
+        doc->cap_spans = cap;
+    }
+
+    memmove(doc->spans + at + n, doc->spans + at + remove, (doc->num_spans - at - remove) * sizeof(DocSpan));
+    if(n)
+        memcpy(doc->spans + at, add, n * sizeof(DocSpan));
+    doc->num_spans = new_count;
+
+    return 1;
+}
+
+
+// Allocates edited span text
+static TextBuf* newTextBuf() {
+    TextBuf* tb = malloc(sizeof(TextBuf));
+
+    if(tb && !tbInit(tb)) {
+        free(tb);
+        return NULL;
+    }
+
+    return tb;
+}
+
+
+// Creates empty document holding a single empty line
+// Returns zero on allocation failure
+int docInit(Doc* doc) {
+    memset(doc, 0, sizeof(*doc));
+
+    DocSpan span = { .edited = 1, .tb = newTextBuf() };
+    if(!span.tb || !tbInsert(span.tb, 0, "\n", 1) || !spliceSpans(doc, 0, 0, &span, 1)) {
+        docFree(doc);
+        if(span.tb) {
+            tbFree(span.tb);
+            free(span.tb);
+        }
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Creates document over read-only original content
+// Lines are indexed by a background thread, content is never copied until edited
+// 'data' must stay mapped until docFree
+// Returns zero on failure
+int docOpen(Doc* doc, const char* data, size_t size) {
+    if(size == 0) // Nothing to map, start empty
+        return docInit(doc);
+
+    memset(doc, 0, sizeof(*doc));
+
+    DocOrig* o = &doc->orig;
+    o->data = data;
+    o->size = size;
+
+    // Sized for worst case, only pages actually written take memory
+    o->marks = malloc((size / DOC_MARK_STRIDE + 2) * sizeof(size_t));
+    if(!o->marks)
+        return 0;
+
+    DocSpan span = { .edited = 0, .first = 0, .count = DOC_TO_END };
+    if(!spliceSpans(doc, 0, 0, &span, 1)) {
+        free(o->marks);
+        return 0;
+    }
+
+    pthread_mutex_init(&o->lock, NULL);
+    pthread_cond_init(&o->cond, NULL);
+
+    if(pthread_create(&o->scanner, NULL, scanLines, o) != 0) {
+        pthread_mutex_destroy(&o->lock);
+        pthread_cond_destroy(&o->cond);
+        free(o->marks);
+        free(doc->spans);
+        return 0;
+    }
+
+    doc->has_orig = 1;
+    return 1;
+}
+
+
+// Frees document, stopping the scanner if still running
+// Original content is left mapped for the caller to release
+void docFree(Doc* doc) {
+    if(doc->has_orig) {
+        __atomic_store_n(&doc->orig.stop, 1, __ATOMIC_RELAXED);
+        pthread_join(doc->orig.scanner, NULL);
+        pthread_mutex_destroy(&doc->orig.lock);
+        pthread_cond_destroy(&doc->orig.cond);
+        free(doc->orig.marks);
+    }
+
+    for(size_t i = 0; i < doc->num_spans; i++) {
+        if(doc->spans[i].edited) {
+            tbFree(doc->spans[i].tb);
+            free(doc->spans[i].tb);
+        }
+    }
+
+    free(doc->spans);
+    memset(doc, 0, sizeof(*doc));
+}
+
+
+// Returns number of lines known so far
+// Grows while the original is still being indexed
+size_t docLineCount(Doc* doc) {
+    size_t lines = 0;
+
+    for(size_t i = 0; i < doc->num_spans; i++)
+        lines += spanLines(doc, &doc->spans[i]);
+
+    return lines;
+}
+
+
+// Returns non-zero once every line of the original is indexed
+int docIndexDone(Doc* doc) {
+    return !doc->has_orig || DONE(&doc->orig);
+}
+
+
+// Blocks until at least 'n' lines are known or the whole document is indexed
+void docWaitLines(Doc* doc, size_t n) {
+    while(doc->has_orig && !DONE(&doc->orig) && docLineCount(doc) < n)
+        origWaitMore(&doc->orig, READY(&doc->orig));
+}
+
+
+// Finds span holding line 'y'
+// Span index and line within span written to out arguments
+// Returns zero if line does not exist
+static int findSpan(Doc* doc, size_t y, size_t* si, size_t* ly) {
+    docWaitLines(doc, y + 1);
+
+    for(size_t i = 0; i < doc->num_spans; i++) {
+        size_t lines = spanLines(doc, &doc->spans[i]);
+
+        if(y < lines) {
+            *si = i;
+            *ly = y;
+            return 1;
+        }
+
+        y -= lines;
+    }
+
+    return 0;
+}
+
+
+// Locates content of line 'y'
+// Either sets 'tb' and line within it, or byte range in original
+// Returns zero if line does not exist
+static int locateLine(Doc* doc, size_t y, TextBuf** tb, size_t* ly, size_t* start, size_t* end) {
+    size_t si;
+    if(!findSpan(doc, y, &si, ly))
+        return 0;
+
+    DocSpan* s = &doc->spans[si];
+    *tb = s->edited ? s->tb : NULL;
+
+    if(!s->edited) {
+        *start = origLineStart(&doc->orig, s->first + *ly);
+        *end = origLineEnd(&doc->orig, *start);
+    }
+
+    return 1;
+}
+
+
+// Returns length of line 'y' excluding newline
+size_t docLineLength(Doc* doc, size_t y) {
+    TextBuf* tb;
+    size_t ly, start, end;
+
+    if(!locateLine(doc, y, &tb, &ly, &start, &end))
+        return 0;
+
+    return tb ? tbLineLength(tb, ly) : end - start;
+}
+
+
+// Copies up to 'n' bytes of line 'y' starting at column 'x'
+// Returns number of bytes copied
+size_t docCopyLine(Doc* doc, size_t y, size_t x, size_t n, char* out) {
+    TextBuf* tb;
+    size_t ly, start, end;
+
+    if(!locateLine(doc, y, &tb, &ly, &start, &end))
+        return 0;
+
+    size_t len = tb ? tbLineLength(tb, ly) : end - start;
+    if(x >= len)
+        return 0;
+    if(n > len - x)
+        n = len - x;
+
+    if(tb)
+        return tbCopy(tb, tbLineStart(tb, ly) + x, n, out);
+
+    memcpy(out, doc->orig.data + start + x, n);
+    return n;
+}
+
+
+// Appends original line 'k' and its newline to 'tb' at 'pos'
+// Returns zero on allocation failure
+static int copyOrigLine(Doc* doc, size_t k, TextBuf* tb, size_t pos) {
+    size_t start = origLineStart(&doc->orig, k);
+    size_t end = origLineEnd(&doc->orig, start);
+
+    return tbInsert(tb, pos, doc->orig.data + start, end - start) &&
+           tbInsert(tb, pos + end - start, "\n", 1);
+}
+
+
+// Drops an original span that no longer holds any lines
+static void dropIfEmpty(Doc* doc, size_t si) {
+    DocSpan* s = &doc->spans[si];
+
+    if(!s->edited && s->count == 0)
+        spliceSpans(doc, si, 1, NULL, 0);
+}
+
+
+// Ensures line 'y' lives in an edited span
+// Untouched neighbouring lines stay in the original
+// Span index and line within it written to out arguments
+// Returns span text, or NULL on failure
+static TextBuf* materialize(Doc* doc, size_t y, size_t* si, size_t* ly) {
+    if(!findSpan(doc, y, si, ly))
+        return NULL;
+
+    DocSpan* s = &doc->spans[*si];
+    if(s->edited)
+        return s->tb;
+
+    size_t k = s->first + *ly;
+
+    // First line of span directly after an edited span joins it
+    if(*ly == 0 && *si > 0 && doc->spans[*si - 1].edited) {
+        TextBuf* tb = doc->spans[*si - 1].tb;
+        if(!copyOrigLine(doc, k, tb, tbLength(tb)))
+            return NULL;
+
+        s->first++;
+        if(s->count != DOC_TO_END)
+            s->count--;
+
+        dropIfEmpty(doc, *si);
+        (*si)--;
+        *ly = tbLineCount(tb) - 2;
+        return tb;
+    }
+
+    // Last line of bounded span directly before an edited span joins it
+    if(s->count != DOC_TO_END && *ly == s->count - 1 && *si + 1 < doc->num_spans && doc->spans[*si + 1].edited) {
+        TextBuf* tb = doc->spans[*si + 1].tb;
+        if(!copyOrigLine(doc, k, tb, 0))
+            return NULL;
+
+        s->count--;
+
+        if(s->count == 0)
+            dropIfEmpty(doc, *si);
+        else
+            (*si)++;
+
+        *ly = 0;
+        return tb;
+    }
+
+    // Split span around the line
+    DocSpan parts[3];
+    size_t n = 0, edit_at;
+
+    if(*ly > 0)
+        parts[n++] = (DocSpan){ .edited = 0, .first = s->first, .count = *ly };
+
+    edit_at = n;
+    parts[n++] = (DocSpan){ .edited = 1, .tb = newTextBuf() };
+
+    if(s->count == DOC_TO_END)
+        parts[n++] = (DocSpan){ .edited = 0, .first = k + 1, .count = DOC_TO_END };
+    else if(s->count - *ly - 1 > 0)
+        parts[n++] = (DocSpan){ .edited = 0, .first = k + 1, .count = s->count - *ly - 1 };
+
+    TextBuf* tb = parts[edit_at].tb;
+
+    if(!tb || !copyOrigLine(doc, k, tb, 0) || !spliceSpans(doc, *si, 1, parts, n)) {
+        if(tb) {
+            tbFree(tb);
+            free(tb);
+        }
+        return NULL;
+    }
+
+    *si += edit_at;
+    *ly = 0;
+    return tb;
+}
+
+
+// Moves the line following edited span 'si' into it
+// Whole neighbouring edited spans are merged at once
+// Returns zero if there is no following line
+static int pullNextLine(Doc* doc, size_t si) {
+    TextBuf* tb = doc->spans[si].tb;
+
+    while(si + 1 < doc->num_spans) {
+        DocSpan* next = &doc->spans[si + 1];
+
+        if(next->edited) { // Merge both runs of the neighbouring text
+            const char *a, *b;
+            size_t a_len, b_len;
+            tbSegments(next->tb, &a, &a_len, &b, &b_len);
+
+            if(!tbInsert(tb, tbLength(tb), a, a_len) || !tbInsert(tb, tbLength(tb), b, b_len))
+                return 0;
+
+            tbFree(next->tb);
+            free(next->tb);
+            spliceSpans(doc, si + 1, 1, NULL, 0);
+            return 1;
+        }
+
+        if(spanLines(doc, next) == 0) { // Exhausted tail of original
+            docWaitLines(doc, docLineCount(doc) + 1);
+
+            if(spanLines(doc, next) == 0) {
+                next->count = 0;
+                dropIfEmpty(doc, si + 1);
+                continue;
+            }
+        }
+
+        if(!copyOrigLine(doc, next->first, tb, tbLength(tb)))
+            return 0;
+
+        next->first++;
+        if(next->count != DOC_TO_END)
+            next->count--;
+
+        dropIfEmpty(doc, si + 1);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// Inserts 'n' bytes of 's' at column 'x' of line 'y'
+// Newlines in 's' split lines
+// Returns zero on failure
+int docInsert(Doc* doc, size_t y, size_t x, const char* s, size_t n) {
+    size_t si, ly;
+    TextBuf* tb = materialize(doc, y, &si, &ly);
+    if(!tb)
+        return 0;
+
+    size_t len = tbLineLength(tb, ly);
+    if(x > len)
+        x = len;
+
+    return tbInsert(tb, tbLineStart(tb, ly) + x, s, n);
+}
+
+
+// Deletes 'n' bytes starting at column 'x' of line 'y'
+// Each newline crossed joins the following line
+// The document's final line cannot be joined past
+// Returns zero on failure
+int docDelete(Doc* doc, size_t y, size_t x, size_t n) {
+    size_t si, ly;
+    TextBuf* tb = materialize(doc, y, &si, &ly);
+    if(!tb)
+        return 0;
+
+    size_t pos = tbLineStart(tb, ly) + x;
+
+    // Span's final newline must stay, so bring in lines being joined
+    while(pos + n >= tbLength(tb)) {
+        if(!pullNextLine(doc, si)) {
+            n = pos + 1 < tbLength(tb) ? tbLength(tb) - pos - 1 : 0;
+            break;
+        }
+    }
+
+    tbDelete(tb, pos, n);
+    return 1;
+}
+
+
+// Describes whole document as contiguous chunks in order
+// Waits for indexing to finish
+// Caller must free returned array, chunks valid until next edit
+// Number of chunks written to 'count', returns NULL on failure
+struct iovec* docChunks(Doc* doc, int* count) {
+    if(doc->has_orig) // Need final line count of original
+        docWaitLines(doc, (size_t)-1);
+
+    // Up to two chunks per span plus a newline after an unterminated original
+    struct iovec* iov = malloc((doc->num_spans * 2 + 1) * sizeof(struct iovec));
+    if(!iov)
+        return NULL;
+
+    static const char newline = '\n';
+    int n = 0;
+
+    for(size_t i = 0; i < doc->num_spans; i++) {
+        DocSpan* s = &doc->spans[i];
+
+        if(s->edited) { // Runs either side of the gap
+            const char *a, *b;
+            size_t a_len, b_len;
+            tbSegments(s->tb, &a, &a_len, &b, &b_len);
+
+            if(a_len) iov[n++] = (struct iovec){ (void*)a, a_len };
+            if(b_len) iov[n++] = (struct iovec){ (void*)b, b_len };
+            continue;
+        }
+
+        size_t lines = spanLines(doc, s);
+        if(lines == 0)
+            continue;
+
+        size_t start = origLineStart(&doc->orig, s->first);
+        size_t end = origLineStart(&doc->orig, s->first + lines);
+        iov[n++] = (struct iovec){ (void*)(doc->orig.data + start), end - start };
+
+        if(end == doc->orig.size && doc->orig.data[end - 1] != '\n') // Terminate final line
+            iov[n++] = (struct iovec){ (void*)&newline, 1 };
+    }
+
+    *count = n;
+    return iov;
+}
+
+
+// Finds first match of 'needle' at or after column 'x' of line 'y'
+// Needle must not contain '\n', so matches lie within one line
+// Original text is scanned in place, lines are counted only up to the match
+// Returns non-zero with match position in 'fy' and 'fx'
+int docFind(Doc* doc, size_t y, size_t x, const char* needle, size_t m, size_t* fy, size_t* fx) {
+    size_t si, ly;
+    if(m == 0 || !findSpan(doc, y, &si, &ly))
+        return 0;
+
+    size_t base = y - ly; // Document line of span's first line
+    char* line = NULL; // Copy of edited line, contiguous across the gap
+    size_t line_cap = 0;
+    int found = 0;
+
+    for(; si < doc->num_spans && !found; si++, ly = 0, x = 0) {
+        DocSpan* s = &doc->spans[si];
+
+        if(s->edited) { // Search line by line
+            size_t lines = tbLineCount(s->tb) - 1;
+
+            for(; ly < lines && !found; ly++, x = 0) {
+                size_t len = tbLineLength(s->tb, ly);
+                if(x >= len)
+                    continue;
+
+                if(len > line_cap) {
+                    char* grown = realloc(line, len);
+                    if(!grown)
+                        break;
+                    line = grown;
+                    line_cap = len;
+                }
+
+                tbCopy(s->tb, tbLineStart(s->tb, ly) + x, len - x, line);
+                const char* p = searchFind(line, len - x, needle, m);
+
+                if(p) {
+                    *fy = base + ly;
+                    *fx = x + (p - line);
+                    found = 1;
+                }
+            }
+
+            base += lines;
+            continue;
+        }
+
+        // Search original span as one range
+        DocOrig* o = &doc->orig;
+        origWaitLine(o, s->first + ly);
+        size_t line_start = origLineStart(o, s->first + ly);
+        size_t line_end = origLineEnd(o, line_start);
+        size_t start = line_start + (x < line_end - line_start ? x : line_end - line_start);
+
+        size_t end = o->size;
+        if(s->count != DOC_TO_END) {
+            origWaitLine(o, s->first + s->count);
+            end = origLineStart(o, s->first + s->count);
+        }
+
+        const char* p = searchFind(o->data + start, end - start, needle, m);
+
+        if(p) { // Count lines between span start and match
+            size_t k = ly;
+            const char* q = o->data + line_start;
+
+            for(const char* nl; (nl = memchr(q, '\n', p - q)); q = nl + 1)
+                k++;
+
+            *fy = base + k;
+            *fx = p - q;
+            found = 1;
+        }
+
+        base += spanLines(doc, s);
+    }
+
+    free(line);
+    return found;
+}
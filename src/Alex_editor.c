@@ -1,5 +1,10 @@
+#define _GNU_SOURCE // memrchr
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 #include <termios.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -7,36 +12,105 @@
 #include "../include/Alex_queue.h"
 
 #include "../include/Alex_libFS2025.h"
-
-
-#define MAX_LINES 5000
+#include "../include/Alex_doc.h"
+#include "../include/Alex_editor.h"
+#include "../include/Alex_editorInternal.h"
+#include "../include/Alex_journal.h"
+#include "../include/Alex_undo.h"
 
 
 // Data to track editor state
 char* filename = NULL; // Name of open file
 char exit_editor; // Set when graceful exit requested
 struct termios orig_termios; // Holds terminal state and config
-char *lines[MAX_LINES]; // Holds each line of data in buffer
-int line_count = 0; // Number of lines in buffer
+Doc doc = { 0 }; // Holds text of buffer, one line per '\n'
+const char* orig_data = NULL; // Read-only mapping of file being edited
+size_t orig_size = 0;
+int64_t orig_mtime = 0; // Modification time of mapped file, identifies it to journal
+char dirty = 0; // Set once buffer differs from saved file
+Journal journal = { 0 }; // Records edits for recovery after a crash
+char recovered = 0; // Set when session resumed edits from a journal
+UndoLog history = { 0 }; // Edits available to undo and redo
+char status_msg[128] = ""; // Shown in status bar until next key press
+
+// Incremental search state
+#define SEARCH_QUERY_SIZE 128
+char searching = 0; // Set while search prompt is shown
+char query[SEARCH_QUERY_SIZE]; // Text searched for
+size_t query_len = 0;
+char query_found = 0; // Set if query matched
+int search_cy = 0, search_cx = 0; // Cursor when search began, restored on cancel
+int search_row_off = 0, search_col_off = 0;
 int cx = 0, cy = 0; // cursor x and y position
 
+// Rendering state
+// Frames are diffed against the previous one so only changed rows are sent
+typedef struct {
+    char *data;
+    size_t len, cap;
+} FrameBuf;
+
+FrameBuf frame = { 0 }; // Output collected for current frame
+char **prev_rows = NULL; // Row contents shown by previous frame
+int *prev_lens = NULL; // Row lengths shown by previous frame
+char *row_buf = NULL; // Scratch row being built
+int frame_valid = 0; // Cleared when screen must be fully redrawn
+int screen_rows = 0, screen_cols = 0; // Terminal size
+int row_off = 0, col_off = 0; // Text position at top-left of screen
+volatile sig_atomic_t window_resized = 1; // Set by SIGWINCH
+
+#define TAB_STOP 8 // Columns between tab stops
+#define LINE_CHUNK 256 // Bytes of a line examined per copy when mapping columns
+
+// Input state
+// Input is read in bulk, bytes of an unfinished escape sequence wait for the next read
+#define INPUT_BUF_SIZE 4096
+#define KEY_PASTE_START 1000 // Decoded start of bracketed paste
+#define PASTE_END "\x1b[201~" // Terminal marks end of pasted text with this
+
+char in_buf[INPUT_BUF_SIZE]; // Bytes read but not yet decoded
+size_t in_len = 0;
+char pasting = 0; // Set between bracketed paste markers
+FrameBuf paste = { 0 }; // Text of paste in progress
+
 
 // Saves currently open file
-// Returns non-zero on success
+// Streams buffer chunks straight into file system without joining them
+// Unchanged buffers are not rewritten
+// Returns non-zero on success, reason for failure left in status message
 // Handles file opening and closing automatically
-char saveFile(char* content) {
+char saveFile() {
+    if(!dirty) // Nothing to write
+        return 1;
+
+    int count;
+    struct iovec *chunks = docChunks(&doc, &count); // Pieces of buffer in order
+    if(!chunks) {
+        snprintf(status_msg, sizeof(status_msg), "Save failed: out of memory");
+        return 0;
+    }
+
     // Get virtual file descriptor
     int descriptor = fileOpen(filename);
     
-    if(descriptor == -1) // File open error
+    if(descriptor == -1) { // File open error
+        snprintf(status_msg, sizeof(status_msg), "Save failed: %s", libfsStrerror(libfsLastError()));
+        free(chunks);
         return 0;
+    }
 
     // Update file data
-    if(fileWrite(descriptor, content) == LIBFS_ERR)
-        return 0;
+    int ret = fileWritev(descriptor, chunks, count);
+    if(ret == LIBFS_ERR) // Reason read before close can replace it
+        snprintf(status_msg, sizeof(status_msg), "Save failed: %s", libfsStrerror(libfsLastError()));
     
     fileClose(descriptor); // Close file
+    free(chunks);
 
+    if(ret == LIBFS_ERR)
+        return 0;
+
+    dirty = 0;
     return 1;
 }
 
@@ -44,11 +118,14 @@ char saveFile(char* content) {
 // Function to ensure cursor stays withing file bounds
 // Moves cuser into valid position if buffer bounds exceeded
 void clamp_cursor() {
+    docWaitLines(&doc, cy + 1); // Cursor line may not be indexed yet
+    int line_count = docLineCount(&doc); // Get number of lines in buffer
+
     // Ensure cursor is in valid vertical position
     if(cy < 0) cy = 0; // Handle cursor before first line
     if(cy >= line_count) cy = line_count - 1; // Handle cursor after last line
 
-    int len = strlen(lines[cy]); // Get length of current line
+    int len = docLineLength(&doc, cy); // Get length of current line
     
     // Ensure cursor within start and end of line
     if(cx < 0) cx = 0; // Handle cursor before line start
@@ -67,7 +144,7 @@ void die(const char *s) {
 // Restores terminal for regular use
 // Exits program if restore fails
 void disableRawMode() {
-    write(STDOUT_FILENO, "\x1b[?25h", 6); // show cursor
+    write(STDOUT_FILENO, "\x1b[?2004l\x1b[?25h", 14); // stop bracketed paste, show cursor
 
     // Attempt to restore original terminal settings
     if(tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios) == -1)
@@ -93,134 +170,673 @@ void enableRawMode() {
     raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
     raw.c_oflag &= ~(OPOST);
 
+    // Reads time out after 100ms so escape sequences and indexing progress are not waited on
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 1;
+
     // Flush input before applying confing changes
     if(tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == -1)
         die("tcsetattr"); // Exit on failure
+
+    write(STDOUT_FILENO, "\x1b[?2004h", 8); // Have pastes marked so they insert in one step
 }
 
 
 // Inserts char 'c' into buffer at location ('x', 'y')
-void insert_char(int y, int x, char c) {
-    char *line = lines[y]; // Get current line
-    int len = strlen(line); // Get length of current line
+// Amortized constant time while edits stay near the cursor
+// Returns zero if insert failed, nothing is recorded then
+int insert_char(int y, int x, char c) {
+    if(!docInsert(&doc, y, x, &c, 1)) // Add new char, clamped to line end
+        return 0;
+
+    journalRecord(&journal, JOURNAL_INSERT, y, x, &c, 1);
+    undoRecord(&history, UNDO_INSERT, y, x, &c, 1); // Typing runs merge into one step
+    dirty = 1;
+    return 1;
+}
 
-    if(x > len) x = len; // clamp cursor location
 
-    // Add new char at selected location
-    line = realloc(line, len + 2); // Increase length of line in memory
-    memmove(&line[x+1], &line[x], len - x + 1); // Shift line data if needed
-    line[x] = c; // Add new char
-    lines[y] = line; // Update pointer to new line
+// Deletes char before given location
+// Returns zero if nothing was deleted, nothing is recorded then
+int delete_char(int y, int x) {
+    int len = docLineLength(&doc, y); // Get length of line
+    if(x == 0 || x > len) return 0; // Validate cursor within line bounds
+
+    char c;
+    docCopyLine(&doc, y, x - 1, 1, &c); // Keep char so deletion can be undone
+
+    if(!docDelete(&doc, y, x - 1, 1)) // Remove char
+        return 0;
+
+    journalRecord(&journal, JOURNAL_DELETE, y, x - 1, NULL, 1);
+    undoRecord(&history, UNDO_DELETE, y, x - 1, &c, 1);
+    dirty = 1;
+    return 1;
 }
 
 
-// Deletes char at given location
-void delete_char(int y, int x) {
-    char *line = lines[y]; // Get line being deleted from
-    int len = strlen(line); // Get length of line
-    if(x == 0 || len == 0) return; // Validate cursor within line bounds
+// Inserts 'n' bytes of 's' at cursor as one buffer operation
+// Moves cursor to end of inserted text
+// Not recorded in undo history, callers decide how it undoes
+// Returns zero if insert failed, buffer and cursor are unchanged then
+int insert_text(const char *s, size_t n) {
+    if(n == 0 || !docInsert(&doc, cy, cx, s, n))
+        return 0;
+
+    journalRecord(&journal, JOURNAL_INSERT, cy, cx, s, n);
+    dirty = 1;
+
+    // Cursor follows last inserted line
+    const char *last = memrchr(s, '\n', n);
+    if(!last) {
+        cx += n;
+        return 1;
+    }
 
-    memmove(&line[x-1], &line[x], len - x + 1); // Shift line data
+    for(const char *p = s; p <= last; p++)
+        cy += *p == '\n';
+    cx = s + n - last - 1;
+    return 1;
+}
+
+
+// Moves cursor to next match of query at or after ('x', 'y')
+// Wraps around to start of buffer, cursor returns to search start if no match
+void search_from(size_t y, size_t x) {
+    size_t fy, fx;
+
+    query_found = docFind(&doc, y, x, query, query_len, &fy, &fx) ||
+                  docFind(&doc, 0, 0, query, query_len, &fy, &fx);
+
+    if(query_found) {
+        cy = fy;
+        cx = fx;
+    }
+    else {
+        cy = search_cy;
+        cx = search_cx;
+    }
+}
+
+
+// Adds typeable characters of 's' to query and searches again from search start
+void search_append(const char *s, size_t n) {
+    for(size_t i = 0; i < n && query_len < SEARCH_QUERY_SIZE; i++) {
+        if(s[i] >= 32 && s[i] <= 126)
+            query[query_len++] = s[i];
+    }
+
+    search_from(search_cy, search_cx);
+}
+
+
+// Handles key press while search prompt is shown
+// Query is searched as it is typed
+void search_key(int k) {
+    switch(k) {
+        case '\r': // Keep cursor at match
+            searching = 0;
+            break;
+
+        case '\x1b': // Return to where search began
+            searching = 0;
+            cy = search_cy;
+            cx = search_cx;
+            row_off = search_row_off;
+            col_off = search_col_off;
+            break;
+
+        case 6: // ctrl+f jumps to following match
+            if(query_len)
+                search_from(cy, cx + 1);
+            break;
+
+        case 127: // Shorten query
+            if(query_len) {
+                query_len--;
+                if(query_len)
+                    search_from(search_cy, search_cx);
+                else {
+                    cy = search_cy;
+                    cx = search_cx;
+                }
+            }
+            break;
+
+        default:
+            if(k >= 32 && k <= 126) {
+                char c = k;
+                search_append(&c, 1);
+            }
+            break;
+    }
+}
+
+
+// Inserts text collected from a bracketed paste
+// Line breaks become '\n', other control characters except tabs are dropped
+void insert_paste() {
+    if(searching) { // Paste into search prompt instead
+        search_append(paste.data, paste.len);
+        return;
+    }
+
+    size_t n = 0;
+
+    for(size_t i = 0; i < paste.len; i++) {
+        char c = paste.data[i];
+
+        if(c == '\r') { // Terminals send enter as '\r', skip '\n' of "\r\n"
+            paste.data[n++] = '\n';
+            if(i + 1 < paste.len && paste.data[i + 1] == '\n')
+                i++;
+        }
+        else if(c == '\n' || c == '\t' || (unsigned char)c >= 32) { // Tabs and UTF-8 kept
+            paste.data[n++] = c;
+        }
+    }
+
+    // Whole paste undoes as one step, recorded once it is in the buffer
+    int y = cy, x = cx;
+
+    if(insert_text(paste.data, n)) {
+        undoBreak(&history);
+        undoRecord(&history, UNDO_INSERT, y, x, paste.data, n);
+        undoBreak(&history);
+    }
+
+    clamp_cursor();
+}
+
+
+// Applies edit of an undo or redo step
+// Cursor moves to where the edit happened
+void apply_history(int op, size_t y, size_t x, const char *s, size_t n) {
+    cy = y;
+    cx = x;
+
+    if(op == UNDO_INSERT) { // Restore text, cursor ends after it
+        insert_text(s, n);
+        return;
+    }
+
+    docDelete(&doc, y, x, n);
+    journalRecord(&journal, JOURNAL_DELETE, y, x, NULL, n);
+    dirty = 1;
 }
 
 
 // Get text from editor
 // Returns full buffer as char*
-// Appends '\0' to returned data
+// Every line ends in '\n', '\0' appended to returned data
 // Caller must free returned data
 char* get_full_text() {
-    size_t total = 0; // Total number of bytes in buffer
+    int count;
+    struct iovec *chunks = docChunks(&doc, &count); // Pieces of buffer in order
+    if(!chunks)
+        return NULL;
 
-    // Calculate total size
-    for (int i = 0; i < line_count; i++)
-        total += strlen(lines[i]) + 1; // +1 for '\n'
+    size_t total = 0; // Total number of bytes in buffer
+    for(int i = 0; i < count; i++)
+        total += chunks[i].iov_len;
 
-    // Allocate space for buffer data
+    // Allocate space for buffer data and terminator
     char *buffer = malloc(total + 1);
-    buffer[0] = '\0';
 
-    // Copy lines into buffer
-    for (int i = 0; i < line_count; i++) {
-        strcat(buffer, lines[i]); // Copy line data
-        strcat(buffer, "\n"); // Append newline
+    if(buffer) { // Copy text out of buffer
+        char *p = buffer;
+        for(int i = 0; i < count; i++) {
+            memcpy(p, chunks[i].iov_base, chunks[i].iov_len);
+            p += chunks[i].iov_len;
+        }
+        *p = '\0';
     }
 
+    free(chunks);
     return buffer; // Return pointer to start of data
 }
 
 
-// Clear terminal screen and hides cursor
-void clear_screen() {
-    write(STDOUT_FILENO, "\x1b[?25l", 6);  // hide cursor
-    write(STDOUT_FILENO, "\x1b[2J", 4);    // clear screen
-    write(STDOUT_FILENO, "\x1b[H", 3);     // move cursor home
+// Grows frame buffer to hold 'n' more bytes
+// Exits editor if memory runs out mid-frame
+void frame_reserve(size_t n) {
+    if(frame.len + n <= frame.cap)
+        return;
+
+    size_t cap = frame.cap ? frame.cap * 2 : 4096;
+    while(cap < frame.len + n)
+        cap *= 2;
+
+    char *grown = realloc(frame.data, cap);
+    if(!grown)
+        die("realloc");
+
+    frame.data = grown;
+    frame.cap = cap;
+}
+
+
+// Appends 'n' bytes to frame being built
+void frame_append(const char *s, size_t n) {
+    frame_reserve(n);
+    memcpy(frame.data + frame.len, s, n);
+    frame.len += n;
+}
+
+
+// Signal handler noting terminal size change
+void handle_winch(int sig) {
+    (void)sig;
+    window_resized = 1;
+}
+
+
+// Reads terminal size and resets previous frame to match
+// Falls back to 24x80 when size cannot be queried
+void resize_screen() {
+    struct winsize ws;
+
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0 || ws.ws_row == 0) {
+        ws.ws_row = 24;
+        ws.ws_col = 80;
+    }
+
+    // Release rows of old size
+    for(int r = 0; r < screen_rows; r++)
+        free(prev_rows[r]);
+    free(prev_rows);
+    free(prev_lens);
+    free(row_buf);
+
+    screen_rows = ws.ws_row;
+    screen_cols = ws.ws_col;
+
+    // One stored row per screen row, each as wide as the screen
+    prev_rows = malloc(screen_rows * sizeof(char*));
+    prev_lens = malloc(screen_rows * sizeof(int));
+    row_buf = malloc(screen_cols + 1);
+
+    if(!prev_rows || !prev_lens || !row_buf)
+        die("malloc");
+
+    for(int r = 0; r < screen_rows; r++) {
+        prev_rows[r] = malloc(screen_cols);
+        if(!prev_rows[r])
+            die("malloc");
+    }
+
+    frame_valid = 0; // Redraw everything at new size
+}
+
+
+// Writes glyph of byte 'c' drawn at screen column 'col' to 'out' if not NULL
+// Tabs expand to next tab stop, control bytes show in caret notation such as ^M,
+// bytes outside ASCII show as '?', so file content never reaches the terminal raw
+// Returns number of columns glyph takes
+int byte_glyph(char c, int col, char *out) {
+    unsigned char u = c;
+
+    if(c == '\t') { // Spaces up to next tab stop
+        int w = TAB_STOP - col % TAB_STOP;
+        if(out)
+            memset(out, ' ', w);
+        return w;
+    }
+
+    if(u < 32 || u == 127) { // Control byte
+        if(out) {
+            out[0] = '^';
+            out[1] = u == 127 ? '?' : u + 64;
+        }
+        return 2;
+    }
+
+    if(out)
+        out[0] = u > 127 ? '?' : c;
+    return 1;
+}
+
+
+// Returns screen column at which byte 'x' of line 'y' is drawn
+// Counted from start of line, before horizontal scrolling
+int render_col(int y, int x) {
+    char chunk[LINE_CHUNK];
+    int col = 0;
+    size_t pos = 0, n;
+
+    while(pos < (size_t)x) {
+        size_t want = x - pos < LINE_CHUNK ? x - pos : LINE_CHUNK;
+        if(!(n = docCopyLine(&doc, y, pos, want, chunk)))
+            break;
+
+        for(size_t i = 0; i < n; i++)
+            col += byte_glyph(chunk[i], col, NULL);
+        pos += n;
+    }
+
+    return col;
+}
+
+
+// Draws screen columns of line 'y' shown in viewport into 'out'
+// Glyphs cut by the left or right edge are drawn in part
+// Returns number of columns drawn, at most screen width
+int render_line(int y, char *out) {
+    char chunk[LINE_CHUNK], glyph[TAB_STOP];
+    int col = 0, len = 0, end = col_off + screen_cols;
+    size_t pos = 0, n;
+
+    while(col < end && (n = docCopyLine(&doc, y, pos, LINE_CHUNK, chunk))) {
+        for(size_t i = 0; i < n && col < end; i++) {
+            int w = byte_glyph(chunk[i], col, glyph);
+
+            for(int g = 0; g < w; g++, col++) {
+                if(col >= col_off && col < end)
+                    out[len++] = glyph[g];
+            }
+        }
+        pos += n;
+    }
+
+    return len;
+}
+
+
+// Scrolls viewport so cursor is visible
+// 'rx' is screen column of cursor, last screen row is reserved for status bar
+void scroll_viewport(int rx) {
+    int text_rows = screen_rows > 1 ? screen_rows - 1 : 1;
+
+    if(cy < row_off) row_off = cy; // Cursor above viewport
+    if(cy >= row_off + text_rows) row_off = cy - text_rows + 1; // Cursor below viewport
+    if(rx < col_off) col_off = rx; // Cursor left of viewport
+    if(rx >= col_off + screen_cols) col_off = rx - screen_cols + 1; // Cursor right of viewport
+}
+
+
+// Emits screen row 'r' if its content differs from previous frame
+// 'attr' optionally wraps content in a display attribute
+void frame_row(int r, const char *content, int len, const char *attr) {
+    if(frame_valid && prev_lens[r] == len && memcmp(prev_rows[r], content, len) == 0)
+        return; // Row unchanged
+
+    char pos[32];
+    int n = snprintf(pos, sizeof(pos), "\x1b[%d;1H", r + 1);
+    frame_append(pos, n);
+
+    if(attr)
+        frame_append(attr, strlen(attr));
+
+    frame_append(content, len);
+
+    if(attr)
+        frame_append("\x1b[m", 3); // Reset attributes
+
+    frame_append("\x1b[K", 3); // Clear rest of row
+
+    // Remember what is on screen now
+    memcpy(prev_rows[r], content, len);
+    prev_lens[r] = len;
 }
- 
 
-// Renders editor screen from scratch
-// Prints every line sequentially
+
+// Renders visible part of buffer into one frame
+// Only rows that changed since last frame are sent, in a single write
+// Text is drawn through byte_glyph so every byte takes a known number of columns
 // Updates and displays cursor to valid position
 // Hides cursor during rendering to prevent flicker
-// Causes incorrect rendering if file taller than terminal window
 void draw_screen() {
-    // Clear screen & move cursor to top-left
-    write(STDOUT_FILENO, "\x1b[3J\x1b[H\x1b[2J", 10);
+    if(window_resized) { // Pick up new terminal size
+        window_resized = 0;
+        resize_screen();
+    }
+
+    int rx = render_col(cy, cx); // Cursor column on screen
+    scroll_viewport(rx);
+    frame.len = 0;
+
+    frame_append("\x1b[?25l", 6); // Hide cursor
 
-    write(STDOUT_FILENO, "\x1b[?25l", 6); // Hide cursor
+    if(!frame_valid) // Start from blank screen
+        frame_append("\x1b[2J", 4);
+
+    // Draw lines within viewport
+    // Waits only for lines on screen if file is still being indexed
+    int text_rows = screen_rows - 1;
+    docWaitLines(&doc, row_off + text_rows);
+    int line_count = docLineCount(&doc);
+
+    for(int r = 0; r < text_rows; r++) {
+        int y = row_off + r;
+        int len = 0;
+
+        if(y < line_count) { // Draw visible columns of line
+            len = render_line(y, row_buf);
+        }
 
-    // Draw all lines without scrolling
-    for(int i = 0; i < line_count; i++) {
-        write(STDOUT_FILENO, lines[i], strlen(lines[i]));
-        write(STDOUT_FILENO, "\r\n", 2);
+        frame_row(r, row_buf, len, NULL);
     }
 
-    // Draw the cursor to (cx, cy)
+    // Draw status bar on last row, search prompt while searching
+    int len;
+    if(status_msg[0])
+        len = snprintf(row_buf, screen_cols + 1, " %s | ^X save and quit  ^Q quit", status_msg);
+    else if(searching)
+        len = snprintf(row_buf, screen_cols + 1, " Search: %.*s%s | Enter accept  Esc cancel  ^F next",
+                       (int)query_len, query, query_len && !query_found ? " (no match)" : "");
+    else
+        len = snprintf(row_buf, screen_cols + 1, " %s%s | %d%s lines | Ln %d, Col %d | ^X save and quit  ^Q quit",
+                       filename, recovered ? " (recovered)" : "", line_count, docIndexDone(&doc) ? "" : "+", cy + 1, cx + 1);
+    if(len > screen_cols) len = screen_cols;
+    frame_row(screen_rows - 1, row_buf, len, "\x1b[7m");
+
+    // Draw the cursor to (cx, cy) relative to viewport
     char buf[32];
-    snprintf(buf, sizeof(buf), "\x1b[%d;%dH", cy+1, cx+1);
-    write(STDOUT_FILENO, buf, strlen(buf));
+    int n = snprintf(buf, sizeof(buf), "\x1b[%d;%dH", cy - row_off + 1, rx - col_off + 1);
+    frame_append(buf, n);
 
-    write(STDOUT_FILENO, "\x1b[?25h", 6); // Redraw cursor
+    frame_append("\x1b[?25h", 6); // Redraw cursor
+
+    // Send whole frame at once
+    size_t sent = 0;
+    while(sent < frame.len) {
+        ssize_t w = write(STDOUT_FILENO, frame.data + sent, frame.len - sent);
+        if(w <= 0)
+            break;
+        sent += w;
+    }
+
+    frame_valid = 1;
 }
 
 
-// Reads single key press from stdin when in raw mode
-// Keys read immediately as line buffering is disabled
-// Returns navigation code if arrrow key
-// Otherwise returns normal character
-int read_key() {
-    char c; // Stores byte froms tdin
-    while (read(STDIN_FILENO, &c, 1) == 0); // Read single byte
+// Maps final byte of an arrow key sequence to its navigation code
+// Returns ESC key for any other byte
+int arrow_key(char c) {
+    switch(c) { // Determine which arrow key
+        case 'A': return 'U'; // Up arrow
+        case 'B': return 'D'; // Down arrow
+        case 'C': return 'R'; // Right arrow
+        case 'D': return 'L'; // Left arrow
+    }
+
+    return '\x1b';
+}
 
-    if(c == '\x1b') { // If escape sequence of ESC key
-        char seq[2]; // Stores bytes if escape sequence
 
-        // Treat as ESC key if next 2 bytes cannot be read
-        if (read(STDIN_FILENO, &seq[0], 1) == 0) return '\x1b';
-        if (read(STDIN_FILENO, &seq[1], 1) == 0) return '\x1b';
+// Decodes one key from 's' holding 'n' pending input bytes
+// Key written to 'key', arrow keys as navigation codes in CSI or SS3 form
+// Unknown escape sequences decode as ESC key
+// Returns bytes consumed, zero if sequence is incomplete
+// Incomplete sequences are decoded as ESC when 'final' is set
+size_t decode_key(const char *s, size_t n, int *key, int final) {
+    *key = s[0];
 
-        if(seq[0] == '[') { // Read escape sequences for arrow keys
-            switch(seq[1]) { // Determine which arrow key
-                case 'A': return 'U'; // Up arrow
-                case 'B': return 'D'; // Down arrow
-                case 'C': return 'R'; // Right arrow
-                case 'D': return 'L'; // Left arrow
-            }
+    if(s[0] != '\x1b') // Normal character
+        return 1;
+
+    if(n < 2) // Lone ESC unless rest of sequence is on its way
+        return final ? 1 : 0;
+
+    if(s[1] == 'O') { // SS3 sequence, sent for arrow keys in application cursor mode
+        if(n < 3) { // Final byte not read yet
+            *key = '\x1b';
+            return final ? n : 0;
         }
 
-        return '\x1b'; // Treat unkown sequences as ESC key
+        *key = arrow_key(s[2]);
+        return 3;
+    }
+
+    if(s[1] != '[') { // Not a control sequence, skip following byte
+        *key = '\x1b';
+        return 2;
     }
 
-    return c; // Return normal character
+    // Control sequence: parameter bytes then one final byte
+    size_t i = 2;
+    while(i < n && s[i] >= 0x30 && s[i] <= 0x3f)
+        i++;
+
+    if(i == n) { // Final byte not read yet
+        *key = '\x1b';
+        return final ? n : 0;
+    }
+
+    *key = '\x1b'; // Treat unkown sequences as ESC key
+
+    if(i == 2) // Read escape sequences for arrow keys
+        *key = arrow_key(s[i]);
+    else if(i == 5 && s[i] == '~' && memcmp(s + 2, "200", 3) == 0) // Bracketed paste begins
+        *key = KEY_PASTE_START;
+
+    return i + 1;
+}
+
+
+// Collects pasted bytes from 's' holding 'n' pending input bytes
+// Inserts whole paste once its end marker arrives
+// Returns bytes consumed, bytes that may begin the end marker are left pending
+size_t take_paste(const char *s, size_t n) {
+    static const char end_marker[] = PASTE_END;
+    size_t marker_len = sizeof(end_marker) - 1;
+
+    // Find end marker, or a partial one at end of input
+    size_t i = 0;
+    for(; i < n; i++) {
+        size_t m = n - i < marker_len ? n - i : marker_len;
+        if(s[i] == '\x1b' && memcmp(s + i, end_marker, m) == 0)
+            break;
+    }
+
+    // Everything before marker is pasted text
+    if(paste.len + i > paste.cap) {
+        size_t cap = paste.cap ? paste.cap : 4096;
+        while(cap < paste.len + i)
+            cap *= 2;
+
+        char *grown = realloc(paste.data, cap);
+        if(!grown)
+            die("realloc");
+
+        paste.data = grown;
+        paste.cap = cap;
+    }
+
+    memcpy(paste.data + paste.len, s, i);
+    paste.len += i;
+
+    if(n - i < marker_len) // Marker incomplete or absent
+        return i;
+
+    insert_paste();
+    pasting = 0;
+    paste.len = 0;
+
+    return i + marker_len;
+}
+
+
+// Applies every complete key and paste held in input buffer
+// 'final' decodes trailing partial sequences instead of waiting for more
+void process_input(int final) {
+    size_t pos = 0;
+
+    while(pos < in_len && !exit_editor) {
+        size_t used;
+
+        if(pasting) { // Inside bracketed paste
+            used = take_paste(in_buf + pos, in_len - pos);
+        }
+        else {
+            int key;
+            used = decode_key(in_buf + pos, in_len - pos, &key, final);
+
+            if(used && key == KEY_PASTE_START)
+                pasting = 1;
+            else if(used)
+                process_key(key);
+        }
+
+        if(!used) // Wait for rest of sequence
+            break;
+
+        pos += used;
+    }
+
+    // Keep undecoded bytes for next read
+    memmove(in_buf, in_buf + pos, in_len - pos);
+    in_len -= pos;
+}
+
+
+// Returns non-zero if more input is waiting to be read
+int input_pending() {
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    return poll(&pfd, 1, 0) > 0;
+}
+
+
+// Reads key presses from stdin when in raw mode
+// Everything available is read in bulk and applied before returning,
+// so a burst of input costs one redraw
+// Returns once input is applied, on a signal, or to refresh indexing progress
+void read_keys() {
+    for(;;) {
+        ssize_t n = read(STDIN_FILENO, in_buf + in_len, INPUT_BUF_SIZE - in_len);
+
+        if(n < 0) // Interrupted, e.g. by resize, redraw without a key
+            return;
+
+        if(n == 0) { // Read timed out
+            if(in_len) { // Sequence never completed, e.g. ESC key
+                process_input(1);
+                return;
+            }
+
+            if(!docIndexDone(&doc)) // Refresh line count while indexing
+                return;
+
+            continue;
+        }
+
+        in_len += n;
+        process_input(in_len == INPUT_BUF_SIZE); // Full buffer cannot wait for more
+
+        if(exit_editor || !input_pending()) // Render once input drained
+            return;
+    }
 }
 
 
 // Handle ctrl + x key presses from user
 // Saves file to virtual file system and closes editor
+// Editor stays open if save fails, showing why in status bar
 void handle_ctrl_x() {
-    char *text = get_full_text(); // Get text from buffer
-    saveFile(text); // Save to file system
+    if(!saveFile()) // Save to file system
+        return;
 
-    free(text); // Free text buffer memory
+    journalStop(&journal, 1); // Edits safe, recovery not needed
     exit_editor = 1; // Signal editor exit
 }
 
@@ -228,57 +844,65 @@ void handle_ctrl_x() {
 // Processes a single key press
 // Handles navigation, control keys, and normal characters to write
 void process_key(int k) {
-    switch (k) { // Handle all key presses
-        // Handle navigation key presses
-        case 'L': if (cx > 0) cx--; break;
-        case 'R': cx++; break;
-        case 'U': if (cy > 0) cy--; break;
-        case 'D': if (cy < line_count - 1) cy++; break;
-        
-        case '\r': {  // Handle enter key for newline
-            char *line = lines[cy]; // Get line being split
-
-            // Split current line into left + right parts
-            char *left = strndup(line, cx); // Text before newline
-            char *right = strdup(line + cx); // Text after newline
+    status_msg[0] = '\0'; // Messages last until next key
 
-            // Replace current line with left part
-            lines[cy] = left;
+    if(searching) { // Keys edit search prompt
+        search_key(k);
+        clamp_cursor();
+        return;
+    }
 
-            // Shift lines to make room for new line
-            for (int i = line_count; i > cy + 1; i--)
-                lines[i] = lines[i - 1];
+    switch (k) { // Handle all key presses
+        // Handle navigation key presses
+        case 'L': if (cx > 0) cx--; undoBreak(&history); break;
+        case 'R': cx++; undoBreak(&history); break;
+        case 'U': if (cy > 0) cy--; undoBreak(&history); break;
+        case 'D': if (cy < (int)docLineCount(&doc) - 1) cy++; undoBreak(&history); break;
 
-            // Insert right part as new line
-            lines[cy + 1] = right;
-            line_count++;
+        case 26: // ctrl+z to undo last edit
+            undoStep(&history, apply_history);
+            break;
 
-            // Update cursor position
-            cy++;
-            cx = 0;
+        case 6: // ctrl+f to search buffer
+            searching = 1;
+            query_len = 0;
+            query_found = 0;
+            search_cy = cy;
+            search_cx = cx;
+            search_row_off = row_off;
+            search_col_off = col_off;
+            undoBreak(&history);
+            break;
 
+        case 25: // ctrl+y to redo last undone edit
+            redoStep(&history, apply_history);
+            break;
+        
+        case '\r': // Handle enter key for newline
+            if(insert_char(cy, cx, '\n')) { // Split line at cursor
+                // Update cursor position
+                cy++;
+                cx = 0;
+            }
             break;
-        }
 
         case 17: // Handle editor exit without saving
+            journalStop(&journal, 1); // Edits abandoned on purpose
             exit_editor = 1; // ctrl+q to quit without saving
+            break;
 
         case 24:  // Handle editor save and quit
             handle_ctrl_x(); // ctrl+x to save and quit
             break;
 
         case 127: // Handle backspace key to delete char
-            if(cx > 0) { // Ensure valid cursor position
-                delete_char(cy, cx); // Delete character
+            if(cx > 0 && delete_char(cy, cx)) // Delete character at valid cursor position
                 cx--; // Update cursor position
-            }
             break;
 
         default: // Insert character if non-special key
-            if(k >= 32 && k <= 126) { // Ensure valid char
-                insert_char(cy, cx, k); // write char to text buffer
+            if(k >= 32 && k <= 126 && insert_char(cy, cx, k)) // write char to text buffer
                 cx++; // Update cursor position
-            }
             break;
     }
 
@@ -286,9 +910,90 @@ void process_key(int k) {
 }
 
 
+// Resets text buffer to a single empty line
+// Frees lines from previous session and homes cursor
+void editorBufferInit() {
+    // Reset editor text state
+    docFree(&doc);
+    undoFree(&history);
+    undoInit(&history);
+
+    // Load one empty line
+    if(!docInit(&doc))
+        die("docInit");
+
+    // Reset cursor position
+    cx = 0;
+    cy = 0;
+    dirty = 0;
+}
+
+
+// Loads existing content of file being edited
+// File is mapped read-only and shown before it is fully indexed
+// Falls back to an empty buffer if file cannot be mapped
+void editorBufferLoad() {
+    editorBufferInit();
+
+    int descriptor = fileOpen(filename);
+    if(descriptor == -1) // Missing file starts empty
+        return;
+
+    if(fileMap(descriptor, &orig_data, &orig_size) == 0 && orig_data) {
+        docFree(&doc);
+
+        if(!docOpen(&doc, orig_data, orig_size))
+            die("docOpen");
+
+        if(fileModTime(descriptor, &orig_mtime) != 0)
+            orig_mtime = 0; // Journal falls back to hashing content
+    }
+
+    fileClose(descriptor); // Mapping outlives descriptor
+}
+
+
+// Applies edit recovered from journal of an unfinished session
+// Leaves cursor at last recovered edit
+void replay_edit(int op, size_t y, size_t x, const char *s, size_t n) {
+    if(op == JOURNAL_INSERT)
+        docInsert(&doc, y, x, s, n);
+    else
+        docDelete(&doc, y, x, n);
+
+    cy = y;
+    cx = op == JOURNAL_INSERT ? x + n : x;
+    dirty = 1;
+}
+
+
+// Restores edits of a session that ended without saving or quitting
+// Then records this session's edits in the background
+void editorJournalStart() {
+    size_t edits;
+    size_t keep = journalReplay(filename, orig_data, orig_size, orig_mtime, replay_edit, &edits);
+
+    recovered = edits > 0;
+    clamp_cursor();
+
+    journalStart(&journal, filename, orig_data, orig_size, orig_mtime, keep);
+}
+
+
+// Releases buffer, history and mapping of edited file
+void editorBufferClose() {
+    docFree(&doc);
+    undoFree(&history);
+    fileUnmap(orig_data, orig_size);
+    orig_data = NULL;
+    orig_size = 0;
+    orig_mtime = 0;
+}
+
+
 // Initialize and run file editor
 // If filename invalid editor will load but not save
-// All files will load as empty and overwrite old data if saved
+// Existing content is loaded lazily, saving overwrites old data
 // Returns zero on success
 int editFile(char* editFilename) {
     if(!editFilename) // Valdate input
@@ -298,37 +1003,36 @@ int editFile(char* editFilename) {
     exit_editor = 0;
     filename = editFilename;
     
-    // Reset editor text state
-    for(int i = 0; i < line_count; i++) {
-        free(lines[i]);
-        lines[i] = NULL;
-    }
-
-    // Reset cursor and line counts
-    line_count = 0;
-    cx = 0;
-    cy = 0;
-    
+    editorBufferLoad();
+    editorJournalStart();
     enableRawMode();
 
-    // Clear the screen BEFORE printing a newline
-    write(STDOUT_FILENO, "\x1b[2J\x1b[H", 7);
+    // Redraw on terminal resize, interrupting blocked reads
+    struct sigaction sa = { .sa_handler = handle_winch }, old_sa;
+    sigaction(SIGWINCH, &sa, &old_sa);
 
-    // Move below the shell prompt
-    write(STDOUT_FILENO, "\n", 1);
+    // First frame measures terminal and clears screen
+    window_resized = 1;
+    row_off = 0;
+    col_off = 0;
 
-    // Load one empty line
-    lines[0] = strdup("");
-    line_count = 1;
+    // No input carried over from previous session
+    searching = 0;
+    status_msg[0] = '\0';
+    in_len = 0;
+    pasting = 0;
+    paste.len = 0;
 
     // Run editor until ext
     while (!exit_editor) {
         draw_screen(); // Render screen
-        int key = read_key(); // Read next key press
-        process_key(key); // Process next key press
+        read_keys(); // Apply all pending key presses
     }
 
     // Ensure graceful exit 
+    journalStop(&journal, 0); // Kept if save failed
+    editorBufferClose();
+    sigaction(SIGWINCH, &old_sa, NULL);
     disableRawMode();
     write(STDOUT_FILENO, "\x1b[2J\x1b[H", 7); // clear screen on exit
     
@@ -0,0 +1,332 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../include/Alex_journal.h"
+
+
+// On-disk layout
+// Header identifies content edits apply to, followed by records in edit order
+#define JOURNAL_MAGIC "XFJRNL2\n"
+#define HEADER_SIZE (8 + 3 * sizeof(uint64_t)) // Magic, base size, base mtime, base hash
+#define RECORD_SIZE (1 + 3 * sizeof(uint32_t)) // Op, line, column, byte count
+
+
+// Builds path of journal kept for 'filename'
+static void journalPath(char* out, const char* filename) {
+    snprintf(out, JOURNAL_PATH_SIZE, "%s%s.journal", JOURNAL_DIR, filename);
+}
+
+
+// FNV-1a hash of base content, detects journals left for other content
+static uint64_t hashBase(const char* base, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+
+    for(size_t i = 0; i < size; i++) {
+        h ^= (unsigned char)base[i];
+        h *= 1099511628211ull;
+    }
+
+    return h;
+}
+
+
+// Fills 'out' with journal header for base content
+static void buildHeader(char* out, const char* base, size_t size, int64_t mtime) {
+    uint64_t fields[3] = { size, mtime, hashBase(base, size) };
+
+    memcpy(out, JOURNAL_MAGIC, 8);
+    memcpy(out + 8, fields, sizeof(fields));
+}
+
+
+// Checks journal header against base content
+// Size is compared first and content is only hashed if modification time differs,
+// so recovering a large unchanged file does not read all of it
+// Returns non-zero if journal was recorded against this content
+static int headerMatches(const char* header, const char* base, size_t size, int64_t mtime) {
+    uint64_t fields[3];
+    memcpy(fields, header + 8, sizeof(fields));
+
+    if(memcmp(header, JOURNAL_MAGIC, 8) != 0 || fields[0] != size)
+        return 0;
+
+    if(fields[1] == (uint64_t)mtime) // Content untouched since journal began
+        return 1;
+
+    return fields[2] == hashBase(base, size); // Touched, but may hold same content
+}
+
+
+// Writes all 'n' bytes of 'data' to host descriptor 'fd'
+// Returns zero on success
+static int writeAll(int fd, const char* data, size_t n) {
+    while(n) {
+        ssize_t w = write(fd, data, n);
+
+        if(w < 0 && errno == EINTR)
+            continue;
+        if(w <= 0)
+            return -1;
+
+        data += w;
+        n -= w;
+    }
+
+    return 0;
+}
+
+
+// Replays journal left for 'filename' by an unfinished session
+// Edits are only applied if journal was recorded against identical base content
+// A record cut short by a crash ends the replay
+// Number of applied edits written to 'edits'
+// Returns length of valid journal to continue from, zero if there is none
+size_t journalReplay(const char* filename, const char* base, size_t size, int64_t mtime, JournalApply apply, size_t* edits) {
+    char path[JOURNAL_PATH_SIZE];
+    journalPath(path, filename);
+    *edits = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) // No journal, last session ended cleanly
+        return 0;
+
+    // Read whole journal
+    struct stat st;
+    char* data = NULL;
+    size_t len = 0;
+
+    if(fstat(fd, &st) == 0 && st.st_size >= (off_t)HEADER_SIZE && (data = malloc(st.st_size))) {
+        while(len < (size_t)st.st_size) {
+            ssize_t r = read(fd, data + len, st.st_size - len);
+            if(r <= 0)
+                break;
+            len += r;
+        }
+    }
+
+    close(fd);
+
+    // Journal must belong to this content
+    if(len < HEADER_SIZE || !headerMatches(data, base, size, mtime)) {
+        free(data);
+        return 0;
+    }
+
+    // Apply complete records
+    size_t pos = HEADER_SIZE;
+
+    while(len - pos >= RECORD_SIZE) {
+        uint32_t fields[3];
+        unsigned char op = data[pos];
+        memcpy(fields, data + pos + 1, sizeof(fields));
+
+        size_t n = fields[2];
+        size_t body = op == JOURNAL_INSERT ? n : 0;
+
+        if((op != JOURNAL_INSERT && op != JOURNAL_DELETE) || len - pos - RECORD_SIZE < body)
+            break; // Torn or corrupt record
+
+        apply(op, fields[0], fields[1], data + pos + RECORD_SIZE, n);
+        pos += RECORD_SIZE + body;
+        (*edits)++;
+    }
+
+    free(data);
+    return pos;
+}
+
+
+// Opens journal file for writing
+// Continues valid part of an existing journal, or starts one with a fresh header
+// Returns host descriptor, negative on failure
+static int openJournal(Journal* j) {
+    if(j->keep) { // Continue recovered journal, dropping any torn tail
+        int fd = open(j->path, O_WRONLY | O_CLOEXEC);
+
+        if(fd >= 0 && (ftruncate(fd, j->keep) != 0 || lseek(fd, 0, SEEK_END) < 0)) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    int fd = open(j->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if(fd < 0)
+        return -1;
+
+    // Hashing runs here so editing never waits on it
+    char header[HEADER_SIZE];
+    buildHeader(header, j->base, j->base_size, j->base_mtime);
+
+    if(writeAll(fd, header, HEADER_SIZE) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+// Writer thread body
+// Every JOURNAL_INTERVAL_MS takes pending records and appends them to the journal
+static void* writerMain(void* arg) {
+    Journal* j = arg;
+    int fd = openJournal(j);
+
+    char* spare = NULL; // Buffer swapped in for pending records while writing
+    size_t spare_cap = 0;
+
+    pthread_mutex_lock(&j->lock);
+
+    if(fd < 0)
+        j->failed = 1;
+
+    while(!j->failed) {
+        if(!j->stop) { // Sleep until next interval or stop request
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += JOURNAL_INTERVAL_MS / 1000;
+            deadline.tv_nsec += (JOURNAL_INTERVAL_MS % 1000) * 1000000L;
+            if(deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            pthread_cond_timedwait(&j->cond, &j->lock, &deadline);
+        }
+
+        if(j->len) { // Swap buffers so editing continues during write
+            char* batch = j->pending;
+            size_t batch_len = j->len, batch_cap = j->cap;
+
+            j->pending = spare;
+            j->cap = spare_cap;
+            j->len = 0;
+            spare = batch;
+            spare_cap = batch_cap;
+
+            pthread_mutex_unlock(&j->lock);
+            int ok = writeAll(fd, batch, batch_len) == 0 && fdatasync(fd) == 0;
+            pthread_mutex_lock(&j->lock);
+
+            if(!ok)
+                j->failed = 1;
+        }
+
+        if(j->stop)
+            break;
+    }
+
+    pthread_mutex_unlock(&j->lock);
+
+    if(fd >= 0)
+        close(fd);
+    free(spare);
+
+    return NULL;
+}
+
+
+// Starts recording edits of 'filename' made against 'base'
+// Base must stay mapped until journalStop
+// 'keep' continues a journal recovered by journalReplay, zero replaces any old journal
+// Returns zero if recording could not start, editing works regardless
+int journalStart(Journal* j, const char* filename, const char* base, size_t size, int64_t mtime, size_t keep) {
+    memset(j, 0, sizeof(*j));
+    journalPath(j->path, filename);
+    j->base = base;
+    j->base_size = size;
+    j->base_mtime = mtime;
+    j->keep = keep;
+
+    if(mkdir(JOURNAL_DIR, 0700) != 0 && errno != EEXIST)
+        return 0;
+
+    pthread_mutex_init(&j->lock, NULL);
+    pthread_cond_init(&j->cond, NULL);
+
+    if(pthread_create(&j->writer, NULL, writerMain, j) != 0) {
+        pthread_mutex_destroy(&j->lock);
+        pthread_cond_destroy(&j->cond);
+        return 0;
+    }
+
+    j->active = 1;
+    return 1;
+}
+
+
+// Records an edit, 's' holds inserted bytes
+// Only copies into memory, writer thread does all disk I/O
+void journalRecord(Journal* j, int op, size_t y, size_t x, const char* s, size_t n) {
+    if(!j->active)
+        return;
+
+    size_t body = op == JOURNAL_INSERT ? n : 0;
+
+    pthread_mutex_lock(&j->lock);
+
+    if(j->failed) { // Release records that can no longer be written
+        free(j->pending);
+        j->pending = NULL;
+        j->len = j->cap = 0;
+        pthread_mutex_unlock(&j->lock);
+        return;
+    }
+
+    // Grow pending buffer
+    if(j->len + RECORD_SIZE + body > j->cap) {
+        size_t cap = j->cap ? j->cap * 2 : 4096;
+        while(cap < j->len + RECORD_SIZE + body)
+            cap *= 2;
+
+        char* grown = realloc(j->pending, cap);
+        if(!grown) { // Journal would have a gap, stop recording
+            j->failed = 1;
+            pthread_mutex_unlock(&j->lock);
+            return;
+        }
+
+        j->pending = grown;
+        j->cap = cap;
+    }
+
+    uint32_t fields[3] = { y, x, n };
+    char* rec = j->pending + j->len;
+
+    rec[0] = op;
+    memcpy(rec + 1, fields, sizeof(fields));
+    if(body)
+        memcpy(rec + RECORD_SIZE, s, body);
+    j->len += RECORD_SIZE + body;
+
+    pthread_mutex_unlock(&j->lock);
+}
+
+
+// Stops recording, flushing pending records first
+// 'discard' deletes journal, used once edits are saved or abandoned
+void journalStop(Journal* j, int discard) {
+    if(!j->active)
+        return;
+
+    pthread_mutex_lock(&j->lock);
+    j->stop = 1;
+    pthread_cond_signal(&j->cond);
+    pthread_mutex_unlock(&j->lock);
+
+    pthread_join(j->writer, NULL);
+    pthread_mutex_destroy(&j->lock);
+    pthread_cond_destroy(&j->cond);
+    free(j->pending);
+
+    if(discard)
+        unlink(j->path);
+
+    j->active = 0;
+}
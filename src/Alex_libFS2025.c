@@ -1,54 +1,75 @@
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
 #include "../include/Alex_queue.h"
 
 #include "../include/Alex_libFS2025.h"
+#include "../include/Alex_libFSStats.h"
 
 
 // File store directory config
+// May be overridden at build time, e.g. to keep benchmark files apart
+#ifndef LIBFS_BASE_DIR
 #define LIBFS_BASE_DIR ".fsdata/" // Path from project root to where files are saved
+#endif
 
 
-// Invalid file provided by user
-#define ERR_MSG_FNE "Error: File '%s' does not exists.\n" 
-#define ERR_MSG_FAE "Error: File '%s' already exists.\n"
-#define ERR_MSG_IDXNE "Error: File descriptor '%d' does not point to valid file.\n"
+// Full path buffer size, base directory plus longest filename
+#define FULLPATH_SIZE (sizeof(LIBFS_BASE_DIR) + MAX_FILENAME)
 
-// Invalid file open status for requested action
-#define ERR_MSG_FC "Error: File '%s' is closed.\n"
-#define ERR_MSG_FO "Error: File '%s' is already open.\n"
+// Chunks per writev call, limits.h only defines it for X/Open builds
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
 
-// System errors when working with files
-#define ERR_MSG_CND "Error: File '%s' could not be deleted.\n"
-#define ERR_MSG_CNC "Error: Unable to create file '%s'.\n"
+// Prefix of temporary files holding writes in progress, never loaded as files
+#define LIBFS_TMP_PREFIX ".~"
 
-// Success messages when output succeeds
-#define SCS_MSG_FW "Data written to file '%s' successfully.\n"
+// Temporary path buffer size, full path plus prefix and unique suffix
+#define TMPPATH_SIZE (FULLPATH_SIZE + sizeof(LIBFS_TMP_PREFIX) + 7)
+
+// Records error code for calling thread and evaluates to LIBFS_ERR
+#define FAIL(err) (last_error = (err), LIBFS_ERR)
 
 // Macro to check if file descriptor points to valid file
 #define FD_VALID(fd) (fd >= 0 && fd < file_end && file_table[fd].exists)
 
+// Mappings returned by fileMap and not yet released
+// While any exist, writes replace files instead of overwriting them in place
+#define LIVE_MAPS() __atomic_load_n(&live_maps, __ATOMIC_ACQUIRE)
+
 // Global variables to track state
 FileEntry file_table[MAX_FILES] = {0}; // File table to track files where index serves as virtual file descriptor
 int file_count = 0; // Number of files in the system
 int file_end = 0; // Tracks highest used virtual descriptor for file storage 
 Queue free_mem = { NULL, 0 }; // Holds open indices in table less than file count
+static _Thread_local int last_error = LIBFS_OK; // Error code of calling thread's last failure
+
+// Guards file table and free list
+// Reads and writes drop it during host I/O, the open descriptor pins their entry
+pthread_mutex_t fs_lock = PTHREAD_MUTEX_INITIALIZER;
+int live_maps = 0; // Outstanding fileMap mappings
 
 
 // Constructs full filepath from filename
 // Path relative from project root directory
 // Result assigned to out argument
 static void buildFullPath(char* out, const char* filename) {
-    snprintf(out, MAX_FILENAME + 20, "%s%s", LIBFS_BASE_DIR, filename);
+    snprintf(out, FULLPATH_SIZE, "%s%s", LIBFS_BASE_DIR, filename);
 }
 
 
 // Returns index of file if in memory
 // Searches by file name
 int findFile(const char* filename) {
-    for (int i = 0; i < file_count; i++) { // Check all virtual memory addresses
+    for (int i = 0; i < file_end; i++) { // Check all virtual memory addresses
         if(file_table[i].exists && strcmp(file_table[i].filename, filename) == 0)
             return i; // File found
     }
@@ -60,35 +81,38 @@ int findFile(const char* filename) {
 // Create a new file
 // Defaults as empty and closed
 // File saved in LIBFS_BASE_DIR path from project root
-int fileCreate(const char *filename) {
+static int createFile(const char *filename) {
+    // Name must fit in file table entry
+    if(!filename || !filename[0] || strlen(filename) >= MAX_FILENAME)
+        return FAIL(LIBFS_EINVAL);
+
     // Check name for uniqueness
-    if(findFile(filename) != LIBFS_ERR) {
-        // Name already exists
-        printf(ERR_MSG_FAE, filename);
-        return LIBFS_ERR;
-    }
+    if(findFile(filename) != LIBFS_ERR)
+        return FAIL(LIBFS_EEXIST); // Name already exists
 
-    int mem_idx = file_count; // Default mem_idx to next open spot
-
-    if(queueSize(&free_mem)) // Set fragmented mem idx if exists
-        mem_idx = dequeue(&free_mem);
-    else // Increment end of contiguously stored files
-        file_end++;
+    // Check for space in file table
+    if(file_count >= MAX_FILES)
+        return FAIL(LIBFS_ENOSPC);
 
     // Get full path to local file
-    char fullpath[MAX_FILENAME + 20];
+    char fullpath[FULLPATH_SIZE];
     buildFullPath(fullpath, filename);
 
     // Create the file on the local disk
     FILE *file = fopen(fullpath, "w");
 
-    if(!file) { // Failure opening file
-        printf(ERR_MSG_CNC, filename);
-        return LIBFS_ERR;
-    }
+    if(!file) // Failure opening file
+        return FAIL(LIBFS_EIO);
 
     fclose(file); // Close file on host system
 
+    int mem_idx = file_end; // Default mem_idx to next open spot
+
+    if(queueSize(&free_mem)) // Set fragmented mem idx if exists
+        mem_idx = dequeue(&free_mem);
+    else // Increment end of contiguously stored files
+        file_end++;
+
     // Add file to the file table
     strcpy(file_table[mem_idx].filename, filename); // Copy filename
     file_table[mem_idx].size = 0; // Set file as empty
@@ -96,9 +120,6 @@ int fileCreate(const char *filename) {
     file_table[mem_idx].exists = 1; // FileEntry is valid file 
     file_count++;
 
-    // File created successfully
-    printf("File '%s' created successfully.\n", filename);
-
     return 0;
 }
 
@@ -107,20 +128,16 @@ int fileCreate(const char *filename) {
 // Does not open file on host system
 // fails if file is already open or does not exist
 // Returns file descriptor on success
-int fileOpen(const char *filename) {
+static int openFile(const char *filename) {
     int open_idx = findFile(filename); // Get file mem location
 
     // Validate by name that file exists
-    if(open_idx == LIBFS_ERR) {
-        printf(ERR_MSG_FNE, filename);
-        return LIBFS_ERR;
-    }
+    if(open_idx == LIBFS_ERR)
+        return FAIL(LIBFS_ENOENT);
 
     // Validate file not already open
-    if(file_table[open_idx].is_open) {
-        printf(ERR_MSG_FO, filename);
-        return LIBFS_ERR;
-    }
+    if(file_table[open_idx].is_open)
+        return FAIL(LIBFS_EOPEN);
 
     // File opened successfully 
     file_table[open_idx].is_open = 1; // Set file as open
@@ -128,42 +145,138 @@ int fileOpen(const char *filename) {
 }
 
 
-// Write data to a file
+// Writes every byte described by 'iov' to host descriptor 'fd'
+// Issues at most IOV_MAX chunks per call and resumes after short writes
+// Returns zero on success
+static int writeAll(int fd, const struct iovec *iov, int iovcnt) {
+    struct iovec batch[IOV_MAX];
+    int i = 0; // First chunk not fully written
+    size_t done = 0; // Bytes of chunk 'i' already written
+
+    while(i < iovcnt) {
+        // Gather remaining chunks, skipping written part of first
+        int n = 0;
+        for(int j = i; j < iovcnt && n < IOV_MAX; j++) {
+            size_t off = j == i ? done : 0;
+            if(iov[j].iov_len > off)
+                batch[n++] = (struct iovec){ (char *)iov[j].iov_base + off, iov[j].iov_len - off };
+        }
+
+        if(n == 0) // Only empty chunks left
+            break;
+
+        ssize_t w = writev(fd, batch, n);
+        if(w < 0) {
+            if(errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        // Advance past fully written chunks
+        while(i < iovcnt && (size_t)w >= iov[i].iov_len - done) {
+            w -= iov[i].iov_len - done;
+            done = 0;
+            i++;
+        }
+        done += w;
+    }
+
+    return 0;
+}
+
+
+// Writes chunks to temporary file renamed over 'fullpath'
+// Mappings of the old content stay valid, at the cost of a create, chmod and rename
+// Returns zero on success
+static int replaceFile(const char *fullpath, char *tmppath, const struct iovec *iov, int iovcnt) {
+    // Permissions of file being replaced, default if it is missing
+    struct stat st;
+    mode_t mode = 0644;
+
+    if(stat(fullpath, &st) == 0)
+        mode = st.st_mode & 0777;
+    else if(errno != ENOENT)
+        return -1;
+
+    int fd = mkstemp(tmppath);
+    if(fd < 0) // Error opening file
+        return -1;
+
+    // Short write, flush failure, or replace failure leaves old data intact
+    int ok = fchmod(fd, mode) == 0 && writeAll(fd, iov, iovcnt) == 0;
+    ok = close(fd) == 0 && ok;
+
+    if(!ok || rename(tmppath, fullpath) != 0) {
+        unlink(tmppath);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// Writes chunks over content of 'fullpath' in place
+// Returns zero on success
+static int overwriteFile(const char *fullpath, const struct iovec *iov, int iovcnt) {
+    int fd = open(fullpath, O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if(fd < 0)
+        return -1;
+
+    int ok = writeAll(fd, iov, iovcnt) == 0;
+    ok = close(fd) == 0 && ok;
+
+    return ok ? 0 : -1;
+}
+
+
+// Write chunks of data to a file in order
 // Overwrites existing data
+// While any fileMap mapping is live, new content goes to a temporary file renamed
+// over the old one, so mapped old content stays valid while it is streamed back
+// Otherwise the file is overwritten in place with a single open and write
 // Fails if file closed or index invalid
 // Returns number of bytes written
-int fileWrite(int file_index, const char *data) {
+static int writeFile(int file_index, const struct iovec *iov, int iovcnt) {
+    pthread_mutex_lock(&fs_lock);
+
     // Ensure file index is valid
     if(!FD_VALID(file_index)) {
-        printf(ERR_MSG_IDXNE, file_index);
-        return LIBFS_ERR;
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_EBADF);
     }
     
     // Ensure file is open
     if(!file_table[file_index].is_open) {
-        printf(ERR_MSG_FC, file_table[file_index].filename);
-        return LIBFS_ERR;
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_ECLOSED);
     }
 
-    int data_size = strlen(data);
-
-    // Get full path to local file
-    char fullpath[MAX_FILENAME + 20];
+    // Get full path to local file and a unique temporary beside it
+    char fullpath[FULLPATH_SIZE];
+    char tmppath[TMPPATH_SIZE];
     buildFullPath(fullpath, file_table[file_index].filename);
+    snprintf(tmppath, TMPPATH_SIZE, "%s%s%s.XXXXXX", LIBFS_BASE_DIR, LIBFS_TMP_PREFIX, file_table[file_index].filename);
 
-    // Open local file to write data
-    FILE *file = fopen(fullpath, "w");
+    pthread_mutex_unlock(&fs_lock);
 
-    if (!file) { // Error opening file
-        printf("Error: Unable to open file '%s' for writing.\n", file_table[file_index].filename);
-        return LIBFS_ERR;
-    }
+    if(iovcnt < 0 || (iovcnt > 0 && !iov)) // Validate data to write
+        return FAIL(LIBFS_EINVAL);
 
-    fwrite(data, 1, data_size, file); // Write data
-    fclose(file); // Close file
+    // Size must fit file table entry
+    size_t data_size = 0;
+    for(int i = 0; i < iovcnt; i++)
+        data_size += iov[i].iov_len;
 
+    if(data_size > INT_MAX)
+        return FAIL(LIBFS_ERANGE);
+
+    int ret = LIVE_MAPS() ? replaceFile(fullpath, tmppath, iov, iovcnt) : overwriteFile(fullpath, iov, iovcnt);
+    if(ret != 0)
+        return FAIL(LIBFS_EIO);
+
+    pthread_mutex_lock(&fs_lock);
     file_table[file_index].size = data_size; // Update file size metadata
-    printf(SCS_MSG_FW, file_table[file_index].filename); 
+    pthread_mutex_unlock(&fs_lock);
 
     return data_size;
 }
@@ -173,48 +286,48 @@ int fileWrite(int file_index, const char *data) {
 // Fails if file not open or index invalid
 // 'buffer_size' or less of file data is written to 'buffer' arg
 // Returns number of bytes of file data successfully written to 'buffer'
-int fileRead(int file_index, char *buffer, int buffer_size) {
-    if(!FD_VALID(file_index) || !file_table[file_index].is_open) { // Check that file is open and index valid in LIBFS
-        printf("Error: File '%s' is not open.\n", file_table[file_index].filename);
-        return LIBFS_ERR;
-    }
+static int readFile(int file_index, char *buffer, int buffer_size) {
+    pthread_mutex_lock(&fs_lock);
 
-    if(file_table[file_index].size < 1) { // File is empty
-        printf("File '%s' is empty, no data to read\n", file_table[file_index].filename);
-        return 0;
+    if(!FD_VALID(file_index)) { // Ensure file index is valid
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_EBADF);
     }
 
-    if(!buffer || buffer_size < 1) { // Validate buffer for file data
-        printf("Error: Buffer for file data is corrupted.\n");
-        return LIBFS_ERR;
+    if(!file_table[file_index].is_open) { // Check that file is open
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_ECLOSED);
     }
- 
-    // Get full path to local file
-    char fullpath[MAX_FILENAME + 20];
+
+    // Snapshot metadata needed once lock is dropped
+    int size = file_table[file_index].size;
+    char fullpath[FULLPATH_SIZE];
     buildFullPath(fullpath, file_table[file_index].filename);
 
-    // Attempt to open file
-    FILE* file = fopen(fullpath, "r");
+    pthread_mutex_unlock(&fs_lock);
 
-    if(!file) { // File failed to open
-        printf("Error: Unable to open file '%s' for writing.\n", file_table[file_index].filename);
-        return LIBFS_ERR;
-    }
+    if(size < 1) // File is empty, no data to read
+        return 0;
+
+    if(!buffer || buffer_size < 1) // Validate buffer for file data
+        return FAIL(LIBFS_EINVAL);
 
     // Provided buffer too small for data
-    if(file_table[file_index].size > buffer_size)
-        return LIBFS_ERR;
+    if(size > buffer_size)
+        return FAIL(LIBFS_ERANGE);
+
+    // Attempt to open file
+    FILE* file = fopen(fullpath, "r");
+
+    if(!file) // File failed to open
+        return FAIL(LIBFS_EIO);
 
     // Read data into buffer
-    size_t bytes_read = fread(buffer, 1, file_table[file_index].size, file);
+    size_t bytes_read = fread(buffer, 1, size, file);
     fclose(file); // Close local file
 
-    if(bytes_read > 0) { // Display number of bytes read
-        printf("%zu bytes of data read from file '%s' successfully.\n", bytes_read, file_table[file_index].filename);
-    } else { // No bytes read
-        printf("Failed to read data from file %s\n", file_table[file_index].filename);
-        return LIBFS_ERR;
-    }
+    if(bytes_read == 0) // No bytes read
+        return FAIL(LIBFS_EIO);
 
     return bytes_read; // Return number of bytes read
 }
@@ -224,47 +337,145 @@ int fileRead(int file_index, char *buffer, int buffer_size) {
 // Closes file based off file descriptor argument
 // Fails if bad descriptor or file not open
 // Returns zero on success
-int fileClose(int file_index) {
+static int closeFile(int file_index) {
+    if(!FD_VALID(file_index)) // Ensure file index is valid
+        return FAIL(LIBFS_EBADF);
+
+    // Ensure file is open
+    if(!file_table[file_index].is_open)
+        return FAIL(LIBFS_ECLOSED);
+
+    file_table[file_index].is_open = 0; // Mark file as closed
+
+    return 0;
+}
+
+
+// Map file content read-only into memory
+// Fails if file closed or index invalid
+// Mapping stays valid after fileClose, release it with fileUnmap
+// Empty files succeed with NULL data and zero size
+// Returns zero on success
+static int mapFile(int file_index, const char **data, size_t *size) {
+    pthread_mutex_lock(&fs_lock);
+
     if(!FD_VALID(file_index)) { // Ensure file index is valid
-        printf(ERR_MSG_IDXNE, file_index);
-        return LIBFS_ERR;
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_EBADF);
     }
 
-    // Ensure file is open
-    if(!file_table[file_index].is_open) {
-        printf(ERR_MSG_FC, file_table[file_index].filename);
-        return LIBFS_ERR;
+    if(!file_table[file_index].is_open) { // Check that file is open
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_ECLOSED);
     }
 
-    file_table[file_index].is_open = 0; // Mark file as closed
+    // Get full path to local file
+    char fullpath[FULLPATH_SIZE];
+    buildFullPath(fullpath, file_table[file_index].filename);
+
+    pthread_mutex_unlock(&fs_lock);
+
+    *data = NULL;
+    *size = 0;
+
+    int fd = open(fullpath, O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return FAIL(LIBFS_EIO);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return FAIL(LIBFS_EIO);
+    }
 
+    if(st.st_size > 0) { // Map whole file, host descriptor not needed afterwards
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(map == MAP_FAILED) {
+            close(fd);
+            return FAIL(LIBFS_EIO);
+        }
+
+        *data = map;
+        *size = st.st_size;
+        __atomic_fetch_add(&live_maps, 1, __ATOMIC_ACQ_REL);
+    }
+
+    close(fd);
+    return 0;
+}
+
+
+// Releases mapping returned by fileMap
+// Returns zero on success
+int fileUnmap(const char *data, size_t size) {
+    if(!data) // Empty files have nothing mapped
+        return 0;
+
+    if(munmap((void *)data, size) != 0)
+        return FAIL(LIBFS_EINVAL);
+
+    __atomic_fetch_sub(&live_maps, 1, __ATOMIC_ACQ_REL);
+    return 0;
+}
+
+
+// Get time file content was last modified
+// Fails if file closed or index invalid
+// Nanoseconds since the epoch written to 'mtime_ns'
+// Returns zero on success
+static int modTime(int file_index, int64_t *mtime_ns) {
+    pthread_mutex_lock(&fs_lock);
+
+    if(!FD_VALID(file_index)) { // Ensure file index is valid
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_EBADF);
+    }
+
+    if(!file_table[file_index].is_open) { // Check that file is open
+        pthread_mutex_unlock(&fs_lock);
+        return FAIL(LIBFS_ECLOSED);
+    }
+
+    // Get full path to local file
+    char fullpath[FULLPATH_SIZE];
+    buildFullPath(fullpath, file_table[file_index].filename);
+
+    pthread_mutex_unlock(&fs_lock);
+
+    struct stat st;
+    if(stat(fullpath, &st) != 0)
+        return FAIL(LIBFS_EIO);
+
+    *mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
     return 0;
 }
 
 
 // Delete a file from virtual file system
 // Files accessed by name
+// Fails if file is open
 // Returns zero on success
 // May cause memory fragmentation in virtual file system
-int fileDelete(const char *filename) {
+static int deleteFile(const char *filename) {
     // Search for file by name in memory
     int delete_idx = findFile(filename); 
 
     // File does not exist
-    if(delete_idx == LIBFS_ERR) {
-        printf(ERR_MSG_FNE, filename);
-        return LIBFS_ERR;
-    }
+    if(delete_idx == LIBFS_ERR)
+        return FAIL(LIBFS_ENOENT);
+
+    // Open files are in use by a descriptor holder
+    if(file_table[delete_idx].is_open)
+        return FAIL(LIBFS_EOPEN);
 
     // Get full path to local file
-    char fullpath[MAX_FILENAME + 20];
+    char fullpath[FULLPATH_SIZE];
     buildFullPath(fullpath, filename);
 
     // Delete file from system
-    if(unlink(fullpath)) {
-        printf(ERR_MSG_CND, file_table[delete_idx].filename);
-        return LIBFS_ERR;
-    }
+    if(unlink(fullpath))
+        return FAIL(LIBFS_EIO);
 
     // Mark file as DNE
     file_table[delete_idx].exists = 0;
@@ -284,7 +495,7 @@ int fileDelete(const char *filename) {
 // Caller must free files array but not individual FileEntrys
 // Modification of FileEntry's by user will cause undefined behavior
 // Size of returned array written to num_files arg
-FileEntry** fileList(size_t* num_files) {
+static FileEntry** listFiles(size_t* num_files) {
     FileEntry** files = malloc(file_count * sizeof(FileEntry*));
     *num_files=0;
 
@@ -303,13 +514,11 @@ FileEntry** fileList(size_t* num_files) {
 // Loads any normal files at LIBFS_BASE_DIR-defined path
 // Manual creation of none-text files in LIBFS_BASE_DIR may cause undefined behavior
 // Example: symlinks, directories, executables, etc.
-int libFSLoad() {
+static int loadFiles() {
     DIR *dir = opendir(LIBFS_BASE_DIR); // Attempt to open file-storage directory
 
-    if(!dir) { // Error opening directory
-        printf("Error opening FS base directory");
-        return LIBFS_ERR;
-    }
+    if(!dir) // Error opening directory
+        return FAIL(LIBFS_EIO);
 
     // Read entries from directory
     struct dirent *entry;
@@ -322,8 +531,14 @@ int libFSLoad() {
             strcmp(entry->d_name, ".gitkeep") == 0)
             continue;
 
+        if(strncmp(entry->d_name, LIBFS_TMP_PREFIX, strlen(LIBFS_TMP_PREFIX)) == 0) // Unfinished write
+            continue;
+
+        if(strlen(entry->d_name) >= MAX_FILENAME) // Name would not fit in file table
+            continue;
+
         // Get fullpath to file
-        char fullpath[MAX_FILENAME + 20];
+        char fullpath[FULLPATH_SIZE];
         buildFullPath(fullpath, entry->d_name);
 
         struct stat st;
@@ -356,4 +571,137 @@ int libFSLoad() {
 
     closedir(dir);
     return files_read;
-}
\ No newline at end of file
+}
+
+// Public entry points
+// Each call is timed and counted for libfsStats
+// Table operations run under fs_lock, reads and writes lock internally
+
+
+int fileCreate(const char *filename) {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    int ret = createFile(filename);
+    pthread_mutex_unlock(&fs_lock);
+
+    return libfsStatsRecord(LIBFS_OP_CREATE, start, ret);
+}
+
+
+int fileOpen(const char *filename) {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    int ret = openFile(filename);
+    pthread_mutex_unlock(&fs_lock);
+
+    return libfsStatsRecord(LIBFS_OP_OPEN, start, ret);
+}
+
+
+int fileWrite(int file_index, const char *data) {
+    uint64_t start = libfsStatsStart();
+
+    if(!data) // Validate data to write
+        return libfsStatsRecord(LIBFS_OP_WRITE, start, FAIL(LIBFS_EINVAL));
+
+    struct iovec iov = { (void *)data, strlen(data) };
+    return libfsStatsRecord(LIBFS_OP_WRITE, start, writeFile(file_index, &iov, 1));
+}
+
+
+int fileWritev(int file_index, const struct iovec *iov, int iovcnt) {
+    uint64_t start = libfsStatsStart();
+    return libfsStatsRecord(LIBFS_OP_WRITE, start, writeFile(file_index, iov, iovcnt));
+}
+
+
+int fileRead(int file_index, char *buffer, int buffer_size) {
+    uint64_t start = libfsStatsStart();
+    return libfsStatsRecord(LIBFS_OP_READ, start, readFile(file_index, buffer, buffer_size));
+}
+
+
+int fileMap(int file_index, const char **data, size_t *size) {
+    uint64_t start = libfsStatsStart();
+    return libfsStatsRecord(LIBFS_OP_MAP, start, mapFile(file_index, data, size));
+}
+
+
+int fileModTime(int file_index, int64_t *mtime_ns) {
+    uint64_t start = libfsStatsStart();
+    return libfsStatsRecord(LIBFS_OP_STAT, start, modTime(file_index, mtime_ns));
+}
+
+
+int fileClose(int file_index) {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    int ret = closeFile(file_index);
+    pthread_mutex_unlock(&fs_lock);
+
+    return libfsStatsRecord(LIBFS_OP_CLOSE, start, ret);
+}
+
+
+int fileDelete(const char *filename) {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    int ret = deleteFile(filename);
+    pthread_mutex_unlock(&fs_lock);
+
+    return libfsStatsRecord(LIBFS_OP_DELETE, start, ret);
+}
+
+
+// Returned entries may change under concurrent calls from other threads
+FileEntry** fileList(size_t* num_files) {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    FileEntry** files = listFiles(num_files);
+    pthread_mutex_unlock(&fs_lock);
+
+    libfsStatsRecord(LIBFS_OP_LIST, start, files ? (int)*num_files : LIBFS_ERR);
+    return files;
+}
+
+
+int libFSLoad() {
+    uint64_t start = libfsStatsStart();
+
+    pthread_mutex_lock(&fs_lock);
+    int ret = loadFiles();
+    pthread_mutex_unlock(&fs_lock);
+
+    return libfsStatsRecord(LIBFS_OP_LOAD, start, ret);
+}
+
+
+// Returns error code of the calling thread's most recent failed call
+// Only meaningful directly after a call returned LIBFS_ERR
+int libfsLastError(void) {
+    return last_error;
+}
+
+
+// Returns human readable description of a libFS error code
+const char* libfsStrerror(int err) {
+    switch(err) {
+        case LIBFS_OK: return "Success";
+        case LIBFS_ENOENT: return "File does not exist";
+        case LIBFS_EEXIST: return "File already exists";
+        case LIBFS_EBADF: return "File descriptor does not point to valid file";
+        case LIBFS_ECLOSED: return "File is closed";
+        case LIBFS_EOPEN: return "File is already open";
+        case LIBFS_ENOSPC: return "File table is full";
+        case LIBFS_EINVAL: return "Invalid argument";
+        case LIBFS_ERANGE: return "Buffer too small for file data";
+        case LIBFS_EIO: return "Host file system error";
+    }
+
+    return "Unknown error";
+}
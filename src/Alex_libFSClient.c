@@ -0,0 +1,366 @@
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../include/Alex_libFSClient.h"
+
+
+#define RECV_CHUNK 65536 // Receive buffer space made available per read
+
+
+// Connection state
+// Outgoing requests are batched in 'out' until flushed
+struct FSClient {
+    int fd;
+    uint32_t next_id; // Id assigned to next request
+    char* out; // Queued request frames
+    size_t out_len, out_cap;
+    char* in; // Received bytes, last returned response ends at 'in_off'
+    size_t in_off, in_len, in_cap;
+    int failed; // Set once connection is unusable
+    int last_error; // LibFSError of last failed blocking call
+};
+
+
+// Grows buffer to hold at least 'need' bytes
+// Returns zero on allocation failure
+static int reserve(char** buf, size_t* cap, size_t need) {
+    if(need <= *cap)
+        return 1;
+
+    size_t new_cap = *cap ? *cap : 4096;
+    while(new_cap < need)
+        new_cap *= 2;
+
+    char* grown = realloc(*buf, new_cap);
+    if(!grown)
+        return 0;
+
+    *buf = grown;
+    *cap = new_cap;
+    return 1;
+}
+
+
+// Connect to libfsd listening at 'sock_path'
+// Uses LIBFSD_SOCK_PATH when path is NULL
+// Returns NULL on failure
+FSClient* fsClientConnect(const char* sock_path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+    if(!sock_path)
+        sock_path = LIBFSD_SOCK_PATH;
+
+    if(strlen(sock_path) >= sizeof(addr.sun_path))
+        return NULL;
+
+    strcpy(addr.sun_path, sock_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+        return NULL;
+
+    if(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+        close(fd);
+        return NULL;
+    }
+
+    FSClient* client = calloc(1, sizeof(FSClient));
+    if(!client) {
+        close(fd);
+        return NULL;
+    }
+
+    client->fd = fd;
+    client->next_id = 1;
+    return client;
+}
+
+
+// Closes connection and frees client
+// Server closes any descriptors left open by this client
+void fsClientDisconnect(FSClient* client) {
+    if(!client)
+        return;
+
+    close(client->fd);
+    free(client->out);
+    free(client->in);
+    free(client);
+}
+
+
+// Queues a request frame without sending it
+// Returns id of the queued request, or zero on failure
+uint32_t fsClientSend(FSClient* client, uint16_t op, int32_t arg, int32_t arg2, const void* payload, uint32_t len) {
+    if(!client || client->failed || len > FSP_MAX_PAYLOAD)
+        return 0;
+
+    if(!reserve(&client->out, &client->out_cap, client->out_len + sizeof(FSPHeader) + len))
+        return 0;
+
+    FSPHeader req = {
+        .len = len,
+        .id = client->next_id++,
+        .op = op,
+        .arg = arg,
+        .arg2 = arg2
+    };
+
+    if(client->next_id == 0) // Zero is reserved for failure
+        client->next_id = 1;
+
+    memcpy(client->out + client->out_len, &req, sizeof(req));
+    if(len)
+        memcpy(client->out + client->out_len + sizeof(req), payload, len);
+    client->out_len += sizeof(req) + len;
+
+    return req.id;
+}
+
+
+// Reads whatever responses are available without blocking
+// Bytes are kept after earlier unreturned responses for fsClientRecv
+// Returns zero on failure
+static int drainResponses(FSClient* client) {
+    for(;;) {
+        if(!reserve(&client->in, &client->in_cap, client->in_len + RECV_CHUNK))
+            return 0;
+
+        ssize_t n = recv(client->fd, client->in + client->in_len, client->in_cap - client->in_len, MSG_DONTWAIT);
+
+        if(n > 0) {
+            client->in_len += n;
+            continue;
+        }
+
+        if(n < 0 && errno == EINTR)
+            continue;
+
+        // Nothing more to read yet, or server closed connection
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+
+// Sends all queued requests
+// Responses arriving meanwhile are buffered, so a server that stops reading
+// until its responses are consumed cannot deadlock a large pipeline
+// Returns zero on failure
+int fsClientFlush(FSClient* client) {
+    if(!client || client->failed)
+        return 0;
+
+    size_t sent = 0;
+    while(sent < client->out_len) {
+        struct pollfd pfd = { .fd = client->fd, .events = POLLIN | POLLOUT };
+
+        if(poll(&pfd, 1, -1) < 0) {
+            if(errno == EINTR)
+                continue;
+            client->failed = 1;
+            return 0;
+        }
+
+        if((pfd.revents & (POLLIN | POLLHUP | POLLERR)) && !drainResponses(client)) {
+            client->failed = 1;
+            return 0;
+        }
+
+        if(!(pfd.revents & POLLOUT))
+            continue;
+
+        ssize_t n = send(client->fd, client->out + sent, client->out_len - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if(n < 0) {
+            if(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+                continue;
+            client->failed = 1;
+            return 0;
+        }
+
+        sent += n;
+    }
+
+    client->out_len = 0;
+    return 1;
+}
+
+
+// Waits for the next response
+// Header written to 'rsp', payload pointer valid until next receive
+// Returns zero on failure
+int fsClientRecv(FSClient* client, FSPHeader* rsp, const char** payload) {
+    if(!client || client->failed)
+        return 0;
+
+    // Drop previously returned response
+    memmove(client->in, client->in + client->in_off, client->in_len - client->in_off);
+    client->in_len -= client->in_off;
+    client->in_off = 0;
+
+    // Receive until a full frame is buffered
+    size_t need = sizeof(FSPHeader);
+    while(1) {
+        if(client->in_len >= sizeof(FSPHeader)) { // Header known, wait for payload
+            memcpy(rsp, client->in, sizeof(FSPHeader));
+            need = sizeof(FSPHeader) + rsp->len;
+        }
+
+        if(client->in_len >= need)
+            break;
+
+        if(!reserve(&client->in, &client->in_cap, need)) {
+            client->failed = 1;
+            return 0;
+        }
+
+        ssize_t n = recv(client->fd, client->in + client->in_len, client->in_cap - client->in_len, 0);
+
+        if(n <= 0) {
+            if(n < 0 && errno == EINTR)
+                continue;
+            client->failed = 1;
+            return 0;
+        }
+
+        client->in_len += n;
+    }
+
+    if(payload)
+        *payload = client->in + sizeof(FSPHeader);
+
+    client->in_off = need; // Dropped by the next receive
+    return 1;
+}
+
+
+// Sends one request and waits for its response
+// Returns libFS return value, LIBFS_ERR on connection failure
+static int roundTrip(FSClient* client, uint16_t op, int32_t arg, int32_t arg2, const void* payload, uint32_t len,
+                     FSPHeader* rsp, const char** rsp_payload) {
+    if(!fsClientSend(client, op, arg, arg2, payload, len) || !fsClientFlush(client) ||
+       !fsClientRecv(client, rsp, rsp_payload)) {
+        if(client)
+            client->last_error = LIBFS_EIO;
+        return LIBFS_ERR;
+    }
+
+    if(rsp->arg == LIBFS_ERR)
+        client->last_error = rsp->arg2;
+
+    return rsp->arg;
+}
+
+
+// Sends a request with a filename payload
+static int nameRequest(FSClient* client, uint16_t op, const char* filename) {
+    FSPHeader rsp;
+    return roundTrip(client, op, 0, 0, filename, strlen(filename), &rsp, NULL);
+}
+
+
+// Create a new file on the server
+int fsClientCreate(FSClient* client, const char* filename) {
+    return nameRequest(client, FSP_CREATE, filename);
+}
+
+
+// Open file on the server
+// Returns file descriptor owned by this connection
+int fsClientOpen(FSClient* client, const char* filename) {
+    return nameRequest(client, FSP_OPEN, filename);
+}
+
+
+// Write data to a file opened by this client
+// Returns number of bytes written
+int fsClientWrite(FSClient* client, int file_index, const char* data) {
+    FSPHeader rsp;
+    return roundTrip(client, FSP_WRITE, file_index, 0, data, strlen(data), &rsp, NULL);
+}
+
+
+// Read data from a file opened by this client
+// Returns number of bytes written to 'buffer'
+int fsClientRead(FSClient* client, int file_index, char* buffer, int buffer_size) {
+    FSPHeader rsp;
+    const char* data;
+
+    int ret = roundTrip(client, FSP_READ, file_index, buffer_size, NULL, 0, &rsp, &data);
+
+    // Response larger than requested cannot be trusted, client stops using connection
+    if(ret != LIBFS_ERR && (buffer_size < 0 || rsp.len > (uint32_t)buffer_size || (uint32_t)ret != rsp.len)) {
+        client->failed = 1;
+        client->last_error = LIBFS_EIO;
+        return LIBFS_ERR;
+    }
+
+    if(ret > 0) // Copy file data out of receive buffer
+        memcpy(buffer, data, rsp.len);
+
+    return ret;
+}
+
+
+// Close a file opened by this client
+int fsClientClose(FSClient* client, int file_index) {
+    FSPHeader rsp;
+    return roundTrip(client, FSP_CLOSE, file_index, 0, NULL, 0, &rsp, NULL);
+}
+
+
+// Delete a file on the server
+int fsClientDelete(FSClient* client, const char* filename) {
+    return nameRequest(client, FSP_DELETE, filename);
+}
+
+
+// Returns copies of file metadata held by the server
+// Caller must free returned array
+// Size of returned array written to num_files arg
+FileEntry* fsClientList(FSClient* client, size_t* num_files) {
+    FSPHeader rsp;
+    const char* data;
+    *num_files = 0;
+
+    int count = roundTrip(client, FSP_LIST, 0, 0, NULL, 0, &rsp, &data);
+    if(count < 0)
+        return NULL;
+
+    FileEntry* files = calloc(count ? count : 1, sizeof(FileEntry));
+    if(!files)
+        return NULL;
+
+    // Decode records until payload exhausted
+    const char* p = data;
+    const char* end = data + rsp.len;
+
+    while(*num_files < (size_t)count && end - p >= FSP_LIST_REC_MIN) {
+        uint32_t size;
+        memcpy(&size, p, sizeof(size));
+        uint8_t name_len = p[4];
+
+        if(end - p < FSP_LIST_REC_MIN + name_len || name_len >= MAX_FILENAME)
+            break;
+
+        FileEntry* f = &files[(*num_files)++];
+        memcpy(f->filename, p + FSP_LIST_REC_MIN, name_len);
+        f->filename[name_len] = '\0';
+        f->size = size;
+        f->exists = 1;
+
+        p += FSP_LIST_REC_MIN + name_len;
+    }
+
+    return files;
+}
+
+
+// Returns error code of this client's most recent failed blocking call
+// Connection failures are reported as LIBFS_EIO
+int fsClientLastError(FSClient* client) {
+    return client ? client->last_error : LIBFS_EINVAL;
+}
@@ -0,0 +1,220 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/Alex_libFS2025.h"
+#include "../include/Alex_libFSStats.h"
+
+
+// Counters owned by one thread
+// Only the owner writes, so updates need no read-modify-write atomics
+typedef struct ThreadStats {
+    LibFSOpStats ops[LIBFS_OP_COUNT];
+    struct ThreadStats* next;
+} ThreadStats;
+
+
+// Relaxed load and owner-only store, lets snapshots read counters without tearing
+#define LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define ADD(x, v) __atomic_store_n(&(x), (x) + (v), __ATOMIC_RELAXED)
+
+
+// Counters of running threads, blocks of exited threads are recycled
+// Counts of exited threads are folded into 'retired' so totals never drop
+ThreadStats* all_stats = NULL;
+ThreadStats* free_stats = NULL; // Blocks released by exited threads
+ThreadStats retired = { 0 };
+pthread_mutex_t all_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local ThreadStats* local_stats = NULL;
+
+static pthread_key_t stats_key; // Runs releaseStats as threads exit
+static pthread_once_t stats_key_once = PTHREAD_ONCE_INIT;
+
+
+// Adds counters of 'src' to 'dst'
+// Caller holds all_stats_lock
+static void foldStats(LibFSOpStats* dst, LibFSOpStats* src) {
+    for(int op = 0; op < LIBFS_OP_COUNT; op++) {
+        LibFSOpStats* s = &src[op];
+        LibFSOpStats* d = &dst[op];
+
+        d->calls += LOAD(s->calls);
+        d->errors += LOAD(s->errors);
+        d->bytes += LOAD(s->bytes);
+        d->total_ns += LOAD(s->total_ns);
+
+        uint64_t max_ns = LOAD(s->max_ns);
+        if(max_ns > d->max_ns)
+            d->max_ns = max_ns;
+
+        for(int b = 0; b < LIBFS_HIST_BUCKETS; b++)
+            d->hist[b] += LOAD(s->hist[b]);
+    }
+}
+
+
+// Thread exit destructor
+// Folds exiting thread's counters into retired totals and recycles its block
+static void releaseStats(void* arg) {
+    ThreadStats* ts = arg;
+
+    pthread_mutex_lock(&all_stats_lock);
+
+    foldStats(retired.ops, ts->ops);
+
+    ThreadStats** link = &all_stats;
+    while(*link != ts)
+        link = &(*link)->next;
+    *link = ts->next;
+
+    memset(ts, 0, sizeof(*ts));
+    ts->next = free_stats;
+    free_stats = ts;
+
+    pthread_mutex_unlock(&all_stats_lock);
+
+    local_stats = NULL;
+}
+
+
+// Creates key whose destructor releases thread counters
+static void createStatsKey(void) {
+    pthread_key_create(&stats_key, releaseStats);
+}
+
+
+// Returns calling thread's counters, registering them on first use
+// Reuses a block left by an exited thread when one is free
+// Returns NULL if allocation fails, in which case calls go uncounted
+static ThreadStats* threadStats(void) {
+    if(local_stats)
+        return local_stats;
+
+    pthread_once(&stats_key_once, createStatsKey);
+
+    pthread_mutex_lock(&all_stats_lock);
+
+    ThreadStats* ts = free_stats;
+    if(ts)
+        free_stats = ts->next;
+    else
+        ts = calloc(1, sizeof(ThreadStats));
+
+    if(!ts) {
+        pthread_mutex_unlock(&all_stats_lock);
+        return NULL;
+    }
+
+    ts->next = all_stats;
+    all_stats = ts;
+
+    pthread_mutex_unlock(&all_stats_lock);
+
+    pthread_setspecific(stats_key, ts);
+    local_stats = ts;
+    return ts;
+}
+
+
+// Returns monotonic timestamp in nanoseconds marking start of a call
+uint64_t libfsStatsStart(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+
+// Records completion of a call started at 'start'
+// Positive return values of reads and writes count as bytes moved
+// Returns 'ret' so entry points can record and return in one step
+int libfsStatsRecord(int op, uint64_t start, int ret) {
+    ThreadStats* ts = threadStats();
+    if(!ts)
+        return ret;
+
+    uint64_t ns = libfsStatsStart() - start;
+    LibFSOpStats* s = &ts->ops[op];
+
+    // Log2 bucket of latency
+    int bucket = 63 - __builtin_clzll(ns | 1);
+    if(bucket >= LIBFS_HIST_BUCKETS)
+        bucket = LIBFS_HIST_BUCKETS - 1;
+
+    ADD(s->calls, 1);
+    ADD(s->total_ns, ns);
+    ADD(s->hist[bucket], 1);
+
+    if(ns > s->max_ns)
+        __atomic_store_n(&s->max_ns, ns, __ATOMIC_RELAXED);
+
+    if(ret == LIBFS_ERR)
+        ADD(s->errors, 1);
+    else if(ret > 0 && (op == LIBFS_OP_READ || op == LIBFS_OP_WRITE))
+        ADD(s->bytes, ret);
+
+    return ret;
+}
+
+
+// Writes snapshot of counters summed over all threads to 'out'
+// Includes threads that have exited
+// Counters of concurrently running calls may be partially included
+void libfsStats(LibFSStats* out) {
+    memset(out, 0, sizeof(*out));
+
+    pthread_mutex_lock(&all_stats_lock);
+
+    foldStats(out->ops, retired.ops);
+
+    for(ThreadStats* ts = all_stats; ts; ts = ts->next)
+        foldStats(out->ops, ts->ops);
+
+    pthread_mutex_unlock(&all_stats_lock);
+}
+
+
+// Estimates latency percentile in nanoseconds from histogram
+// 'q' in range [0, 1], interpolates linearly within the matching bucket
+// Returns zero if no calls were recorded
+uint64_t libfsStatsPercentile(const LibFSOpStats* op, double q) {
+    uint64_t total = 0;
+    for(int b = 0; b < LIBFS_HIST_BUCKETS; b++)
+        total += op->hist[b];
+
+    if(total == 0)
+        return 0;
+
+    double target = q * total;
+    uint64_t seen = 0;
+
+    for(int b = 0; b < LIBFS_HIST_BUCKETS; b++) {
+        if(op->hist[b] == 0 || seen + op->hist[b] < target) {
+            seen += op->hist[b];
+            continue;
+        }
+
+        // Position of target within this bucket's range
+        double lo = b ? (double)(1ull << b) : 0;
+        double hi = (double)(1ull << (b + 1));
+        double frac = (target - seen) / op->hist[b];
+        uint64_t ns = lo + frac * (hi - lo);
+
+        return ns < op->max_ns ? ns : op->max_ns;
+    }
+
+    return op->max_ns;
+}
+
+
+// Returns name of a tracked operation
+const char* libfsOpName(int op) {
+    static const char* names[LIBFS_OP_COUNT] = {
+        "create", "open", "write", "read", "close", "delete", "list", "load", "map", "stat"
+    };
+
+    if(op < 0 || op >= LIBFS_OP_COUNT)
+        return "unknown";
+
+    return names[op];
+}
@@ -0,0 +1,499 @@
+#define _GNU_SOURCE // accept4
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../include/Alex_libFS2025.h"
+#include "../include/Alex_libFSProto.h"
+
+
+#define MAX_EVENTS 64
+#define READ_CHUNK 65536
+#define OUT_HIGH_WATER (8u << 20) // Stop reading requests while this much output is queued
+
+
+// State for one client connection
+typedef struct {
+    int fd;
+    char* in; // Bytes received but not yet processed
+    size_t in_len, in_cap;
+    char* out; // Responses not yet sent
+    size_t out_len, out_off, out_cap;
+    char owned[MAX_FILES]; // Descriptors opened through this connection
+    int events; // Currently registered epoll events
+    int peer_closed; // Set once peer stops sending, remaining requests still served
+} Conn;
+
+
+// Server state
+int epoll_fd = -1;
+volatile sig_atomic_t stop_server = 0;
+
+
+// Signal handler requesting graceful shutdown
+static void handleStop(int sig) {
+    (void)sig;
+    stop_server = 1;
+}
+
+
+// Grows buffer to hold at least 'need' bytes
+// Returns zero on allocation failure
+static int reserve(char** buf, size_t* cap, size_t need) {
+    if(need <= *cap)
+        return 1;
+
+    size_t new_cap = *cap ? *cap : 4096;
+    while(new_cap < need)
+        new_cap *= 2;
+
+    char* grown = realloc(*buf, new_cap);
+    if(!grown)
+        return 0;
+
+    *buf = grown;
+    *cap = new_cap;
+    return 1;
+}
+
+
+// Reserves output space for a response carrying up to 'payload' bytes
+// Returns pointer where payload may be written, or NULL on failure
+static char* reserveResponse(Conn* c, size_t payload) {
+    if(!reserve(&c->out, &c->out_cap, c->out_len + sizeof(FSPHeader) + payload))
+        return NULL;
+
+    return c->out + c->out_len + sizeof(FSPHeader);
+}
+
+
+// Appends response header for 'req' to connection output
+// Payload of 'len' bytes must already be written after reserveResponse
+// Failed calls carry the libFS error code in 'arg2'
+static void commitResponse(Conn* c, const FSPHeader* req, int ret, uint32_t len) {
+    FSPHeader rsp = {
+        .len = len,
+        .id = req->id,
+        .op = req->op,
+        .arg = ret,
+        .arg2 = ret == LIBFS_ERR ? libfsLastError() : LIBFS_OK
+    };
+
+    memcpy(c->out + c->out_len, &rsp, sizeof(rsp));
+    c->out_len += sizeof(rsp) + len;
+}
+
+
+// Appends a response with no payload
+static int respond(Conn* c, const FSPHeader* req, int ret) {
+    if(!reserveResponse(c, 0))
+        return 0;
+
+    commitResponse(c, req, ret, 0);
+    return 1;
+}
+
+
+// Appends a failure rejected by the server before reaching libFS
+static int respondErr(Conn* c, const FSPHeader* req, int err) {
+    if(!reserveResponse(c, 0))
+        return 0;
+
+    FSPHeader rsp = {
+        .id = req->id,
+        .op = req->op,
+        .arg = LIBFS_ERR,
+        .arg2 = err
+    };
+
+    memcpy(c->out + c->out_len, &rsp, sizeof(rsp));
+    c->out_len += sizeof(rsp);
+    return 1;
+}
+
+
+// Copies a non-terminated filename out of a payload
+// Returns zero if the name does not fit in a FileEntry
+static int payloadName(char* out, const char* payload, uint32_t len) {
+    if(len == 0 || len >= MAX_FILENAME || memchr(payload, '\0', len))
+        return 0;
+
+    memcpy(out, payload, len);
+    out[len] = '\0';
+    return 1;
+}
+
+
+// Checks that a descriptor was opened by this connection
+static int ownsFd(const Conn* c, int fd) {
+    return fd >= 0 && fd < MAX_FILES && c->owned[fd];
+}
+
+
+// Serves a single request frame
+// Response is appended to the connection's output buffer
+// Returns zero if the connection must be dropped
+static int handleRequest(Conn* c, const FSPHeader* req, const char* payload) {
+    char name[MAX_FILENAME];
+
+    switch(req->op) {
+        case FSP_CREATE:
+            if(!payloadName(name, payload, req->len))
+                return respondErr(c, req, LIBFS_EINVAL);
+            return respond(c, req, fileCreate(name));
+
+        case FSP_OPEN: {
+            if(!payloadName(name, payload, req->len))
+                return respondErr(c, req, LIBFS_EINVAL);
+
+            int fd = fileOpen(name);
+            if(fd >= 0 && fd < MAX_FILES)
+                c->owned[fd] = 1; // Track so it is released on disconnect
+
+            return respond(c, req, fd);
+        }
+
+        case FSP_READ: {
+            if(!ownsFd(c, req->arg))
+                return respondErr(c, req, LIBFS_EBADF);
+
+            if(req->arg2 < 1 || (uint32_t)req->arg2 > FSP_MAX_PAYLOAD)
+                return respondErr(c, req, LIBFS_EINVAL);
+
+            // Read straight into the output buffer behind the header
+            char* data = reserveResponse(c, req->arg2);
+            if(!data)
+                return 0;
+
+            int ret = fileRead(req->arg, data, req->arg2);
+            commitResponse(c, req, ret, ret > 0 ? ret : 0);
+            return 1;
+        }
+
+        case FSP_WRITE: {
+            if(!ownsFd(c, req->arg))
+                return respondErr(c, req, LIBFS_EBADF);
+
+            // Payload written in place, no terminated copy needed
+            struct iovec iov = { (void*)payload, req->len };
+            return respond(c, req, fileWritev(req->arg, &iov, 1));
+        }
+
+        case FSP_CLOSE: {
+            if(!ownsFd(c, req->arg))
+                return respondErr(c, req, LIBFS_EBADF);
+
+            int ret = fileClose(req->arg);
+            if(ret == 0)
+                c->owned[req->arg] = 0;
+
+            return respond(c, req, ret);
+        }
+
+        case FSP_DELETE:
+            if(!payloadName(name, payload, req->len))
+                return respondErr(c, req, LIBFS_EINVAL);
+            return respond(c, req, fileDelete(name));
+
+        case FSP_LIST: {
+            size_t num_files = 0;
+            FileEntry** files = fileList(&num_files);
+
+            // Size list payload before encoding
+            size_t total = 0;
+            for(size_t i = 0; i < num_files; i++)
+                total += FSP_LIST_REC_MIN + strlen(files[i]->filename);
+
+            char* p = reserveResponse(c, total);
+            if(!p) {
+                free(files);
+                return 0;
+            }
+
+            // Encode one record per file
+            for(size_t i = 0; i < num_files; i++) {
+                uint32_t size = files[i]->size;
+                uint8_t name_len = strlen(files[i]->filename);
+
+                memcpy(p, &size, sizeof(size));
+                p[4] = name_len;
+                memcpy(p + FSP_LIST_REC_MIN, files[i]->filename, name_len);
+                p += FSP_LIST_REC_MIN + name_len;
+            }
+
+            free(files);
+            commitResponse(c, req, num_files, total);
+            return 1;
+        }
+    }
+
+    return respondErr(c, req, LIBFS_EINVAL); // Unknown operation
+}
+
+
+// Updates epoll interest for a connection when it changes
+static void setEvents(Conn* c, int events) {
+    if(c->events == events)
+        return;
+
+    struct epoll_event ev = { .events = events, .data.ptr = c };
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->events = events;
+}
+
+
+// Releases connection and any descriptors it left open
+static void closeConn(Conn* c) {
+    for(int i = 0; i < MAX_FILES; i++) {
+        if(c->owned[i])
+            fileClose(i);
+    }
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+
+// Serves every complete frame in the input buffer
+// Pipelined requests are answered in order with one flush per batch
+// Returns zero if the connection must be dropped
+static int processInput(Conn* c) {
+    size_t off = 0;
+
+    while(c->in_len - off >= sizeof(FSPHeader) && c->out_len - c->out_off < OUT_HIGH_WATER) {
+        FSPHeader req;
+        memcpy(&req, c->in + off, sizeof(req));
+
+        if(req.len > FSP_MAX_PAYLOAD) // Malformed frame
+            return 0;
+
+        if(c->in_len - off < sizeof(FSPHeader) + req.len) // Wait for rest of frame
+            break;
+
+        if(!handleRequest(c, &req, c->in + off + sizeof(FSPHeader)))
+            return 0;
+
+        off += sizeof(FSPHeader) + req.len;
+    }
+
+    // Drop consumed bytes
+    memmove(c->in, c->in + off, c->in_len - off);
+    c->in_len -= off;
+    return 1;
+}
+
+
+// Sends as much queued output as the socket accepts
+// Returns zero on a fatal socket error
+static int flushOutput(Conn* c) {
+    while(c->out_off < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+
+        if(n < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            if(errno == EINTR)
+                continue;
+            return 0;
+        }
+
+        c->out_off += n;
+    }
+
+    if(c->out_off == c->out_len) // Fully drained, reuse buffer from start
+        c->out_off = c->out_len = 0;
+
+    return 1;
+}
+
+
+// Handles readiness on a client connection
+// Requests sent before the peer closes its end are served before dropping it
+// Returns zero if the connection must be dropped
+static int serviceConn(Conn* c, uint32_t events) {
+    if(events & EPOLLERR)
+        return 0;
+
+    if((events & (EPOLLIN | EPOLLHUP)) && !c->peer_closed) {
+        // Drain socket into input buffer
+        while(1) {
+            if(!reserve(&c->in, &c->in_cap, c->in_len + READ_CHUNK))
+                return 0;
+
+            ssize_t n = recv(c->fd, c->in + c->in_len, c->in_cap - c->in_len, 0);
+
+            if(n == 0) { // Peer done sending, answer what it sent
+                c->peer_closed = 1;
+                break;
+            }
+
+            if(n < 0) {
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                if(errno == EINTR)
+                    continue;
+                return 0;
+            }
+
+            c->in_len += n;
+        }
+    }
+
+    // Serve pending requests, then send responses
+    // Repeats while output drains since serving pauses at the high water mark
+    while(1) {
+        size_t pending = c->in_len;
+        int backed_up = c->out_len - c->out_off >= OUT_HIGH_WATER; // Serving paused this round
+
+        if(!processInput(c) || !flushOutput(c))
+            return 0;
+
+        // Stop while output is still queued, or once remaining input is an incomplete frame
+        if(c->out_len > 0 || (c->in_len == pending && !backed_up))
+            break;
+    }
+
+    // Closed peer is dropped once all responses are sent
+    // Input left then is an incomplete frame that can never finish
+    if(c->peer_closed && c->out_len == 0)
+        return 0;
+
+    // Stop reading while output backs up, wait for writability instead
+    int events_wanted = 0;
+    if(c->out_len - c->out_off < OUT_HIGH_WATER && !c->peer_closed)
+        events_wanted |= EPOLLIN;
+    if(c->out_len > c->out_off)
+        events_wanted |= EPOLLOUT;
+
+    setEvents(c, events_wanted);
+    return 1;
+}
+
+
+// Accepts all pending connections on listening socket
+static void acceptConns(int listen_fd) {
+    while(1) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if(fd < 0) // No more pending connections
+            return;
+
+        Conn* c = calloc(1, sizeof(Conn));
+        if(!c) {
+            close(fd);
+            continue;
+        }
+
+        c->fd = fd;
+        c->events = EPOLLIN;
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            close(fd);
+            free(c);
+        }
+    }
+}
+
+
+// Creates listening Unix domain socket at 'path'
+// Removes stale socket file from previous runs
+// Returns socket descriptor or -1 on failure
+static int listenUnix(const char* path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+    if(strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path '%s' is too long.\n", path);
+        return -1;
+    }
+
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    if(bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1) {
+        perror("bind");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+// Run libFS server on a Unix domain socket
+// Socket path may be given as first argument
+// Serves clients until SIGINT or SIGTERM
+int main(int argc, char** argv) {
+    const char* sock_path = argc > 1 ? argv[1] : LIBFSD_SOCK_PATH;
+
+    // Install shutdown handlers without SA_RESTART so epoll_wait wakes
+    struct sigaction sa = { .sa_handler = handleStop };
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int files_loaded = libFSLoad();
+    if(files_loaded == LIBFS_ERR) {
+        fprintf(stderr, "Error opening FS base directory: %s\n", libfsStrerror(libfsLastError()));
+        return 1;
+    }
+
+    int listen_fd = listenUnix(sock_path);
+    if(listen_fd < 0)
+        return 1;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(epoll_fd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    // Listening socket is tagged with a NULL connection
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+    printf("libfsd: serving %d files on '%s'\n", files_loaded, sock_path);
+    fflush(stdout);
+
+    struct epoll_event events[MAX_EVENTS];
+
+    while(!stop_server) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for(int i = 0; i < n; i++) {
+            Conn* c = events[i].data.ptr;
+
+            if(!c) // Listening socket
+                acceptConns(listen_fd);
+            else if(!serviceConn(c, events[i].events))
+                closeConn(c);
+        }
+    }
+
+    // Graceful shutdown
+    close(listen_fd);
+    unlink(sock_path);
+
+    return 0;
+}
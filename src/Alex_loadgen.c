@@ -0,0 +1,690 @@
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "../include/Alex_libFS2025.h"
+#include "../include/Alex_libFSStats.h"
+
+
+// Load driver file store, compiled into libFS for this binary
+#ifndef LIBFS_BASE_DIR
+#define LIBFS_BASE_DIR ".fsdata/"
+#endif
+
+#define LOAD_PREFIX "lg_"
+#define TRACE_MAGIC "# loadgen trace v1"
+#define MAX_THREADS 256
+
+
+// Logical operations issued by the driver
+// Writes and reads include their fileOpen and fileClose calls
+enum { OP_CREATE, OP_WRITE, OP_READ, OP_DELETE, OP_KINDS };
+
+static const char* op_names[OP_KINDS] = { "create", "write", "read", "delete" };
+
+
+// Outcome of one issued operation
+enum { OP_OK, OP_FAILED, OP_SKIPPED, OP_RACED };
+
+#define LAT_NONE UINT64_MAX // Latency slot of an op that failed or was skipped
+
+
+// Working set file states
+// Ops move from their chosen file to the next eligible one, so creates only target
+// absent names and reads, writes and deletes only present ones
+enum { FILE_ABSENT, FILE_PRESENT, FILE_BUSY };
+
+
+// One generated or replayed operation
+typedef struct {
+    uint8_t op;
+    uint16_t file; // Index into working set
+    uint32_t size; // Payload bytes for writes
+} Op;
+
+
+// Per-thread work and results
+typedef struct {
+    pthread_t thread;
+    Op* ops;
+    size_t num_ops, cap_ops;
+    uint64_t* lat_ns; // Latency of each issued op, LAT_NONE if it did not complete
+    uint64_t errors[OP_KINDS];
+    uint64_t skipped[OP_KINDS]; // Ops finding no eligible file
+    uint64_t waits[OP_KINDS]; // Retries while another thread held the file open
+    uint64_t raced[OP_KINDS]; // Ops whose file was deleted by another thread before opening
+    char* buffer; // Payload and read buffer
+} Worker;
+
+
+// Workload configuration
+typedef struct {
+    int threads;
+    size_t ops; // Per thread
+    int files; // Working set size
+    int mix[OP_KINDS]; // Relative weights
+    uint32_t size_min, size_max;
+    int size_log; // Log-uniform rather than uniform sizes
+    double skew; // Zipf exponent, zero for uniform access
+    uint64_t seed;
+    const char* record_path;
+    const char* replay_path;
+} Config;
+
+
+Config cfg = {
+    .threads = 4,
+    .ops = 10000,
+    .files = 64,
+    .mix = { 2, 28, 68, 2 },
+    .size_min = 64,
+    .size_max = 65536,
+    .size_log = 1,
+    .skew = 0.99,
+    .seed = 1
+};
+
+Worker workers[MAX_THREADS];
+uint8_t file_state[MAX_FILES]; // State of each working set file
+uint32_t max_size = 0; // Largest payload in the workload
+pthread_barrier_t start_barrier;
+
+
+// Returns monotonic time in nanoseconds
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+
+// xorshift64* generator, one state per thread keeps generation deterministic
+static uint64_t nextRand(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+
+// Returns uniform double in [0, 1)
+static double nextUnit(uint64_t* state) {
+    return (nextRand(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+// Builds working set file name for index 'i'
+static void fileName(char* out, int i) {
+    snprintf(out, MAX_FILENAME, LOAD_PREFIX "%04d", i);
+}
+
+
+// Appends operation to worker's op list
+static void pushOp(Worker* w, Op op) {
+    if(w->num_ops == w->cap_ops) {
+        w->cap_ops = w->cap_ops ? w->cap_ops * 2 : 1024;
+        w->ops = realloc(w->ops, w->cap_ops * sizeof(Op));
+
+        if(!w->ops) {
+            fprintf(stderr, "loadgen: out of memory\n");
+            exit(1);
+        }
+    }
+
+    w->ops[w->num_ops++] = op;
+}
+
+
+// Generates each thread's operations from the configured mix
+// Popular files have low indices when skew is non-zero
+static void generateOps() {
+    // Zipf CDF over working set
+    double* cdf = malloc(cfg.files * sizeof(double));
+    double total = 0;
+
+    for(int i = 0; i < cfg.files; i++) {
+        total += 1.0 / pow(i + 1, cfg.skew);
+        cdf[i] = total;
+    }
+
+    int mix_total = 0;
+    for(int k = 0; k < OP_KINDS; k++)
+        mix_total += cfg.mix[k];
+
+    for(int t = 0; t < cfg.threads; t++) {
+        uint64_t state = cfg.seed * 0x9E3779B97F4A7C15ull + t + 1;
+
+        for(size_t i = 0; i < cfg.ops; i++) {
+            Op op = { 0 };
+
+            // Pick operation kind by weight
+            int pick = nextRand(&state) % mix_total;
+            while(pick >= cfg.mix[op.op])
+                pick -= cfg.mix[op.op++];
+
+            // Pick file by binary search of CDF
+            double u = nextUnit(&state) * total;
+            int lo = 0, hi = cfg.files - 1;
+            while(lo < hi) {
+                int mid = (lo + hi) / 2;
+                if(cdf[mid] < u) lo = mid + 1;
+                else hi = mid;
+            }
+            op.file = lo;
+
+            // Pick payload size
+            double r = nextUnit(&state);
+            if(cfg.size_log)
+                op.size = exp(log(cfg.size_min) + r * (log(cfg.size_max) - log(cfg.size_min)));
+            else
+                op.size = cfg.size_min + r * (cfg.size_max - cfg.size_min);
+
+            pushOp(&workers[t], op);
+        }
+    }
+
+    free(cdf);
+}
+
+
+// Writes generated operations as a replayable text trace
+// One line per op: thread, op name, file index, size
+static int recordTrace(const char* path) {
+    FILE* f = fopen(path, "w");
+    if(!f) {
+        perror(path);
+        return 0;
+    }
+
+    fprintf(f, "%s threads=%d files=%d\n", TRACE_MAGIC, cfg.threads, cfg.files);
+
+    for(int t = 0; t < cfg.threads; t++) {
+        for(size_t i = 0; i < workers[t].num_ops; i++) {
+            Op* op = &workers[t].ops[i];
+            fprintf(f, "%d %s %u %u\n", t, op_names[op->op], op->file, op->size);
+        }
+    }
+
+    return fclose(f) == 0;
+}
+
+
+// Loads operations from a trace written by recordTrace
+// Thread count and working set size come from the trace
+static int loadTrace(const char* path) {
+    FILE* f = fopen(path, "r");
+    if(!f) {
+        perror(path);
+        return 0;
+    }
+
+    char line[128];
+    if(!fgets(line, sizeof(line), f) || strncmp(line, TRACE_MAGIC, strlen(TRACE_MAGIC)) != 0 ||
+       sscanf(line + strlen(TRACE_MAGIC), " threads=%d files=%d", &cfg.threads, &cfg.files) != 2 ||
+       cfg.threads < 1 || cfg.threads > MAX_THREADS || cfg.files < 1) {
+        fprintf(stderr, "loadgen: '%s' is not a loadgen trace\n", path);
+        fclose(f);
+        return 0;
+    }
+
+    int lineno = 1;
+    while(fgets(line, sizeof(line), f)) {
+        lineno++;
+
+        int t;
+        char name[16];
+        unsigned file, size;
+
+        if(sscanf(line, "%d %15s %u %u", &t, name, &file, &size) != 4 || t < 0 || t >= cfg.threads ||
+           file >= (unsigned)cfg.files) {
+            fprintf(stderr, "loadgen: %s:%d: malformed trace line\n", path, lineno);
+            fclose(f);
+            return 0;
+        }
+
+        Op op = { .op = OP_KINDS, .file = file, .size = size };
+        for(int k = 0; k < OP_KINDS; k++) {
+            if(strcmp(name, op_names[k]) == 0)
+                op.op = k;
+        }
+
+        if(op.op == OP_KINDS) {
+            fprintf(stderr, "loadgen: %s:%d: unknown op '%s'\n", path, lineno, name);
+            fclose(f);
+            return 0;
+        }
+
+        pushOp(&workers[t], op);
+    }
+
+    fclose(f);
+    return 1;
+}
+
+
+// Claims working set file for a create or delete
+// Starts at 'file' and moves to following files until one in state 'from' is found
+// Returns claimed index, now busy, or -1 if no file is eligible
+static int claimFile(int file, int from) {
+    for(int k = 0; k < cfg.files; k++) {
+        int i = (file + k) % cfg.files;
+        uint8_t expected = from;
+
+        if(__atomic_compare_exchange_n(&file_state[i], &expected, FILE_BUSY, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return i;
+    }
+
+    return -1;
+}
+
+
+// Finds present working set file for a read or write
+// Starts at 'file' and moves to following files, nothing is claimed
+// Returns index, or -1 if every file is absent or being deleted
+static int presentFile(int file) {
+    for(int k = 0; k < cfg.files; k++) {
+        int i = (file + k) % cfg.files;
+
+        if(__atomic_load_n(&file_state[i], __ATOMIC_ACQUIRE) == FILE_PRESENT)
+            return i;
+    }
+
+    return -1;
+}
+
+
+// Releases file claimed by claimFile in state 'to'
+static void releaseFile(int i, int to) {
+    __atomic_store_n(&file_state[i], to, __ATOMIC_RELEASE);
+}
+
+
+// Opens 'name', waiting while another thread holds it open
+// libFS allows one open per file, so contended opens retry instead of failing
+// Retries counted in 'waits'
+static int openWait(const char* name, uint64_t* waits) {
+    for(;;) {
+        int fd = fileOpen(name);
+        if(fd != LIBFS_ERR || libfsLastError() != LIBFS_EOPEN)
+            return fd;
+
+        (*waits)++;
+        sched_yield();
+    }
+}
+
+
+// Issues one logical operation against libFS
+// Returns OP_OK, OP_FAILED if a libFS call failed, OP_SKIPPED if no file was eligible,
+// or OP_RACED if the chosen file was deleted by another thread before it was opened
+static int issueOp(Worker* w, const Op* op) {
+    char name[MAX_FILENAME];
+    uint64_t* waits = &w->waits[op->op];
+
+    switch(op->op) {
+        case OP_CREATE: { // Creates a file not present
+            int i = claimFile(op->file, FILE_ABSENT);
+            if(i < 0)
+                return OP_SKIPPED;
+
+            fileName(name, i);
+            int ok = fileCreate(name) != LIBFS_ERR;
+
+            releaseFile(i, ok ? FILE_PRESENT : FILE_ABSENT);
+            return ok ? OP_OK : OP_FAILED;
+        }
+
+        case OP_DELETE: { // Deletes a present file once no thread has it open
+            int i = claimFile(op->file, FILE_PRESENT);
+            if(i < 0)
+                return OP_SKIPPED;
+
+            fileName(name, i);
+            int ret;
+            while((ret = fileDelete(name)) == LIBFS_ERR && libfsLastError() == LIBFS_EOPEN) {
+                (*waits)++;
+                sched_yield();
+            }
+
+            releaseFile(i, ret != LIBFS_ERR ? FILE_ABSENT : FILE_PRESENT);
+            return ret != LIBFS_ERR ? OP_OK : OP_FAILED;
+        }
+
+        case OP_WRITE: {
+            int i = presentFile(op->file);
+            if(i < 0)
+                return OP_SKIPPED;
+
+            fileName(name, i);
+            int fd = openWait(name, waits);
+            if(fd == LIBFS_ERR)
+                return libfsLastError() == LIBFS_ENOENT ? OP_RACED : OP_FAILED;
+
+            // Terminate payload at op size, restored afterwards
+            w->buffer[op->size] = '\0';
+            int ok = fileWrite(fd, w->buffer) != LIBFS_ERR;
+            w->buffer[op->size] = 'x';
+
+            return fileClose(fd) != LIBFS_ERR && ok ? OP_OK : OP_FAILED;
+        }
+
+        case OP_READ: {
+            int i = presentFile(op->file);
+            if(i < 0)
+                return OP_SKIPPED;
+
+            fileName(name, i);
+            int fd = openWait(name, waits);
+            if(fd == LIBFS_ERR)
+                return libfsLastError() == LIBFS_ENOENT ? OP_RACED : OP_FAILED;
+
+            int ok = fileRead(fd, w->buffer, max_size + 1) != LIBFS_ERR;
+            return fileClose(fd) != LIBFS_ERR && ok ? OP_OK : OP_FAILED;
+        }
+    }
+
+    return OP_FAILED;
+}
+
+
+// Worker thread body, issues its ops back to back
+// Only completed ops keep a latency, failures, skips and races are counted apart
+static void* runWorker(void* arg) {
+    Worker* w = arg;
+
+    pthread_barrier_wait(&start_barrier);
+
+    for(size_t i = 0; i < w->num_ops; i++) {
+        uint64_t t = nowNs();
+        int ret = issueOp(w, &w->ops[i]);
+        w->lat_ns[i] = ret == OP_OK ? nowNs() - t : LAT_NONE;
+
+        if(ret == OP_FAILED)
+            w->errors[w->ops[i].op]++;
+        else if(ret == OP_SKIPPED)
+            w->skipped[w->ops[i].op]++;
+        else if(ret == OP_RACED)
+            w->raced[w->ops[i].op]++;
+    }
+
+    return NULL;
+}
+
+
+// Orders latencies for percentile lookup
+static int cmpU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+// Prints per-op throughput and latency percentiles across all workers
+// Percentiles cover completed ops only, failed, skipped and raced ops are counted separately
+// libFS counters are reported relative to the 'base' snapshot taken before the run
+static void report(uint64_t wall_ns, const LibFSStats* base) {
+    size_t total_ops = 0;
+    for(int t = 0; t < cfg.threads; t++)
+        total_ops += workers[t].num_ops;
+
+    printf("\nthreads %d, files %d, ops %zu, %.3f s, %.0f ops/s\n\n",
+           cfg.threads, cfg.files, total_ops, wall_ns / 1e9, total_ops / (wall_ns / 1e9));
+
+    printf("%-8s %10s %8s %8s %8s %8s %10s %10s %10s %10s\n", "Op", "Done", "Errors", "Skipped", "Raced", "Waits",
+           "p50 (us)", "p99 (us)", "p999 (us)", "Max (us)");
+
+    uint64_t* lat = malloc((total_ops ? total_ops : 1) * sizeof(uint64_t));
+
+    for(int k = 0; k < OP_KINDS; k++) {
+        size_t n = 0;
+        uint64_t errors = 0, skipped = 0, raced = 0, waits = 0;
+
+        // Gather latencies of this op's completed calls from every worker
+        for(int t = 0; t < cfg.threads; t++) {
+            for(size_t i = 0; i < workers[t].num_ops; i++) {
+                if(workers[t].ops[i].op == k && workers[t].lat_ns[i] != LAT_NONE)
+                    lat[n++] = workers[t].lat_ns[i];
+            }
+            errors += workers[t].errors[k];
+            skipped += workers[t].skipped[k];
+            raced += workers[t].raced[k];
+            waits += workers[t].waits[k];
+        }
+
+        if(n + errors + skipped + raced == 0)
+            continue;
+
+        printf("%-8s %10zu %8llu %8llu %8llu %8llu", op_names[k], n, (unsigned long long)errors,
+               (unsigned long long)skipped, (unsigned long long)raced, (unsigned long long)waits);
+
+        if(n == 0) { // Nothing completed to time
+            printf(" %10s %10s %10s %10s\n", "-", "-", "-", "-");
+            continue;
+        }
+
+        qsort(lat, n, sizeof(uint64_t), cmpU64);
+        printf(" %10.1f %10.1f %10.1f %10.1f\n",
+               lat[(size_t)(0.50 * (n - 1))] / 1000.0,
+               lat[(size_t)(0.99 * (n - 1))] / 1000.0,
+               lat[(size_t)(0.999 * (n - 1))] / 1000.0,
+               lat[n - 1] / 1000.0);
+    }
+
+    free(lat);
+
+    // Per-call view from libFS's own counters
+    LibFSStats stats;
+    libfsStats(&stats);
+
+    printf("\n%-8s %10s %8s %10s %10s\n", "libFS", "Calls", "Errors", "p50 (us)", "p99 (us)");
+    for(int op = 0; op < LIBFS_OP_COUNT; op++) {
+        LibFSOpStats* s = &stats.ops[op];
+
+        // Exclude calls made while preparing the store
+        s->calls -= base->ops[op].calls;
+        s->errors -= base->ops[op].errors;
+        for(int b = 0; b < LIBFS_HIST_BUCKETS; b++)
+            s->hist[b] -= base->ops[op].hist[b];
+
+        if(s->calls == 0)
+            continue;
+
+        printf("%-8s %10llu %8llu %10.1f %10.1f\n", libfsOpName(op),
+               (unsigned long long)s->calls, (unsigned long long)s->errors,
+               libfsStatsPercentile(s, 0.50) / 1000.0, libfsStatsPercentile(s, 0.99) / 1000.0);
+    }
+}
+
+
+// Removes files left by earlier runs and creates the working set
+// Every run starts from the same state so replays are comparable
+static int prepareStore() {
+    if(mkdir(LIBFS_BASE_DIR, 0755) == -1 && errno != EEXIST) {
+        perror("loadgen: mkdir " LIBFS_BASE_DIR);
+        return 0;
+    }
+
+    if(libFSLoad() == LIBFS_ERR) {
+        fprintf(stderr, "loadgen: %s\n", libfsStrerror(libfsLastError()));
+        return 0;
+    }
+
+    size_t num_files = 0;
+    FileEntry** files = fileList(&num_files);
+    char (*names)[MAX_FILENAME] = malloc((num_files ? num_files : 1) * MAX_FILENAME);
+    size_t stale = 0;
+
+    for(size_t i = 0; i < num_files; i++) {
+        if(strncmp(files[i]->filename, LOAD_PREFIX, strlen(LOAD_PREFIX)) == 0)
+            strcpy(names[stale++], files[i]->filename);
+    }
+
+    for(size_t i = 0; i < stale; i++)
+        fileDelete(names[i]);
+
+    free(names);
+    free(files);
+
+    // Working set starts with every file present and empty
+    for(int i = 0; i < cfg.files; i++) {
+        char name[MAX_FILENAME];
+        fileName(name, i);
+
+        if(fileCreate(name) == LIBFS_ERR) {
+            fprintf(stderr, "loadgen: cannot create '%s': %s\n", name, libfsStrerror(libfsLastError()));
+            return 0;
+        }
+
+        file_state[i] = FILE_PRESENT;
+    }
+
+    return 1;
+}
+
+
+// Prints command line options
+static void usage(const char* prog) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --threads N        worker threads (default 4)\n"
+        "  --ops N            operations per thread (default 10000)\n"
+        "  --files N          working set size, at most MAX_FILES (default 64)\n"
+        "  --mix C:W:R:D      create/write/read/delete weights (default 2:28:68:2)\n"
+        "  --size MIN:MAX     payload size range in bytes (default 64:65536)\n"
+        "  --size-dist D      'log' or 'uniform' payload sizes (default log)\n"
+        "  --skew S           Zipf exponent of file popularity, 0 = uniform (default 0.99)\n"
+        "  --seed N           generator seed (default 1)\n"
+        "  --record FILE      write generated ops as a trace\n"
+        "  --replay FILE      run ops from a trace instead of generating\n",
+        prog);
+}
+
+
+// Parses command line into cfg
+// Returns zero on invalid options
+static int parseArgs(int argc, char** argv) {
+    for(int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if(!val)
+            return 0;
+        i++;
+
+        if(strcmp(opt, "--threads") == 0)
+            cfg.threads = atoi(val);
+        else if(strcmp(opt, "--ops") == 0)
+            cfg.ops = strtoull(val, NULL, 10);
+        else if(strcmp(opt, "--files") == 0)
+            cfg.files = atoi(val);
+        else if(strcmp(opt, "--mix") == 0) {
+            if(sscanf(val, "%d:%d:%d:%d", &cfg.mix[0], &cfg.mix[1], &cfg.mix[2], &cfg.mix[3]) != 4)
+                return 0;
+        }
+        else if(strcmp(opt, "--size") == 0) {
+            if(sscanf(val, "%u:%u", &cfg.size_min, &cfg.size_max) != 2)
+                return 0;
+        }
+        else if(strcmp(opt, "--size-dist") == 0) {
+            if(strcmp(val, "log") == 0)
+                cfg.size_log = 1;
+            else if(strcmp(val, "uniform") == 0)
+                cfg.size_log = 0;
+            else
+                return 0;
+        }
+        else if(strcmp(opt, "--skew") == 0)
+            cfg.skew = atof(val);
+        else if(strcmp(opt, "--seed") == 0)
+            cfg.seed = strtoull(val, NULL, 10);
+        else if(strcmp(opt, "--record") == 0)
+            cfg.record_path = val;
+        else if(strcmp(opt, "--replay") == 0)
+            cfg.replay_path = val;
+        else
+            return 0;
+    }
+
+    int mix_total = cfg.mix[0] + cfg.mix[1] + cfg.mix[2] + cfg.mix[3];
+
+    return cfg.threads >= 1 && cfg.threads <= MAX_THREADS &&
+           cfg.files >= 1 && cfg.files <= MAX_FILES &&
+           cfg.mix[0] >= 0 && cfg.mix[1] >= 0 && cfg.mix[2] >= 0 && cfg.mix[3] >= 0 && mix_total > 0 &&
+           cfg.size_min >= 1 && cfg.size_min <= cfg.size_max && cfg.skew >= 0;
+}
+
+
+// Run synthetic or replayed multi-threaded workload against libFS
+// Reports throughput and latency percentiles per operation
+int main(int argc, char** argv) {
+    if(!parseArgs(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Build op lists before touching the store
+    if(cfg.replay_path) {
+        if(!loadTrace(cfg.replay_path))
+            return 1;
+    }
+    else {
+        generateOps();
+
+        if(cfg.record_path && !recordTrace(cfg.record_path))
+            return 1;
+    }
+
+    if(cfg.files > MAX_FILES) {
+        fprintf(stderr, "loadgen: trace uses %d files, table holds %d\n", cfg.files, MAX_FILES);
+        return 1;
+    }
+
+    // Size shared payload buffers for largest op
+    for(int t = 0; t < cfg.threads; t++) {
+        for(size_t i = 0; i < workers[t].num_ops; i++) {
+            if(workers[t].ops[i].size > max_size)
+                max_size = workers[t].ops[i].size;
+        }
+    }
+
+    for(int t = 0; t < cfg.threads; t++) {
+        Worker* w = &workers[t];
+        w->lat_ns = malloc((w->num_ops ? w->num_ops : 1) * sizeof(uint64_t));
+        w->buffer = malloc(max_size + 1);
+
+        if(!w->lat_ns || !w->buffer) {
+            fprintf(stderr, "loadgen: out of memory\n");
+            return 1;
+        }
+
+        memset(w->buffer, 'x', max_size + 1);
+    }
+
+    if(!prepareStore())
+        return 1;
+
+    // Release all workers at once
+    pthread_barrier_init(&start_barrier, NULL, cfg.threads + 1);
+
+    for(int t = 0; t < cfg.threads; t++)
+        pthread_create(&workers[t].thread, NULL, runWorker, &workers[t]);
+
+    LibFSStats base;
+    libfsStats(&base);
+
+    pthread_barrier_wait(&start_barrier);
+    uint64_t start = nowNs();
+
+    for(int t = 0; t < cfg.threads; t++)
+        pthread_join(workers[t].thread, NULL);
+
+    report(nowNs() - start, &base);
+
+    pthread_barrier_destroy(&start_barrier);
+    return 0;
+}
@@ -0,0 +1,370 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/Alex_search.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEARCH_X86 1
+#endif
+
+
+// Finds 'needle' by locating its first byte with memchr and verifying the rest
+// Fallback for short tails and targets without vector support
+static const char* findScalar(const char* hay, size_t n, const char* needle, size_t m) {
+    if(n < m)
+        return NULL;
+
+    const char* end = hay + n - m + 1; // One past last possible start
+
+    for(const char* p = hay; (p = memchr(p, needle[0], end - p)); p++) {
+        if(memcmp(p + 1, needle + 1, m - 1) == 0)
+            return p;
+    }
+
+    return NULL;
+}
+
+
+#ifdef SEARCH_X86
+
+// Candidate starts are positions where both first and last needle bytes match
+// 16 positions tested per step, only candidates are verified in full
+static const char* findSSE2(const char* hay, size_t n, const char* needle, size_t m) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+
+    for(; i + m - 1 + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(hay + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(hay + i + m - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+
+        while(mask) { // Verify middle bytes of each candidate in order
+            unsigned bit = __builtin_ctz(mask);
+            if(memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0)
+                return hay + i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(hay + i, n - i, needle, m);
+}
+
+
+// Same filter as findSSE2, 32 positions per step
+__attribute__((target("avx2")))
+static const char* findAVX2(const char* hay, size_t n, const char* needle, size_t m) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+
+    for(; i + m - 1 + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(hay + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(hay + i + m - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+
+        while(mask) {
+            unsigned bit = __builtin_ctz(mask);
+            if(memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0)
+                return hay + i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(hay + i, n - i, needle, m);
+}
+
+#endif
+
+
+// Multi-byte search used by searchFind, chosen once by pickFind
+typedef const char* (*FindFn)(const char* hay, size_t n, const char* needle, size_t m);
+static FindFn find_impl = findScalar;
+static pthread_once_t find_once = PTHREAD_ONCE_INIT;
+
+
+// Selects widest vector filter the CPU supports
+static void pickFind(void) {
+#ifdef SEARCH_X86
+    find_impl = __builtin_cpu_supports("avx2") ? findAVX2 : findSSE2;
+#endif
+}
+
+
+// Returns first occurrence of 'm' bytes of 'needle' in 'n' bytes of 'hay'
+// Empty needle matches at start, returns NULL if not found
+const char* searchFind(const char* hay, size_t n, const char* needle, size_t m) {
+    if(m == 0)
+        return hay;
+    if(n < m)
+        return NULL;
+    if(m == 1) // Single byte, memchr is already vectorized
+        return memchr(hay, needle[0], n);
+
+    pthread_once(&find_once, pickFind);
+    return find_impl(hay, n, needle, m);
+}
+
+
+// Copies up to 'n' bytes of line text into 'out' as printable text
+// Control bytes use caret notation and bytes above 127 show as '?', matching the editor
+// Stops before overflowing SEARCH_EXCERPT, 'out' is always terminated
+static void copyExcerpt(char* out, const char* line, size_t n) {
+    size_t len = 0;
+
+    for(size_t i = 0; i < n; i++) {
+        unsigned char u = line[i];
+        char glyph[2] = { u, 0 };
+        size_t w = 1;
+
+        if(u > 127) // Not ASCII
+            glyph[0] = '?';
+        else if(u != '\t' && (u < 32 || u == 127)) { // Control byte
+            glyph[0] = '^';
+            glyph[1] = u == 127 ? '?' : u + 64;
+            w = 2;
+        }
+
+        if(len + w > SEARCH_EXCERPT - 1)
+            break;
+        memcpy(out + len, glyph, w);
+        len += w;
+    }
+
+    out[len] = '\0';
+}
+
+
+// Counts matches of 'pattern' in file content
+// Line and column found only for matches kept, so long files are scanned once
+static void scanMatches(SearchResult* r, const char* data, size_t size, const char* pattern, size_t m) {
+    const char* end = data + size;
+    const char* counted = data; // Newlines before this are counted
+    const char* line_start = data;
+    size_t line = 1;
+
+    for(const char* p = data; (p = searchFind(p, end - p, pattern, m)); p += m) {
+        if(r->num_hits < SEARCH_MAX_HITS) {
+            for(const char* q = counted; (q = memchr(q, '\n', p - q)); q++) {
+                line++;
+                line_start = q + 1;
+            }
+            counted = p;
+
+            SearchHit* hit = &r->hits[r->num_hits++];
+            hit->line = line;
+            hit->col = p - line_start + 1;
+
+            // Excerpt runs to end of line or excerpt size
+            const char* nl = memchr(line_start, '\n', end - line_start);
+            size_t len = (nl ? nl : end) - line_start;
+            if(len > SEARCH_EXCERPT - 1)
+                len = SEARCH_EXCERPT - 1;
+
+            copyExcerpt(hit->text, line_start, len);
+        }
+
+        r->matches++;
+    }
+}
+
+
+// Searches one file, recording libFS failures in result
+static void searchFile(SearchResult* r, const char* pattern, size_t m) {
+    int fd = fileOpen(r->filename);
+    if(fd == LIBFS_ERR) {
+        r->error = libfsLastError();
+        return;
+    }
+
+    const char* data;
+    size_t size;
+    int ret = fileMap(fd, &data, &size);
+
+    if(ret == LIBFS_ERR)
+        r->error = libfsLastError();
+
+    fileClose(fd); // Mapping outlives descriptor
+
+    if(ret == LIBFS_ERR)
+        return;
+
+    scanMatches(r, data, size, pattern, m);
+    fileUnmap(data, size);
+}
+
+
+// Work shared by search threads
+typedef struct {
+    SearchResult* results;
+    size_t count;
+    size_t next; // Index of next file to claim
+    const char* pattern;
+    size_t m;
+} SearchJob;
+
+
+// Worker thread body
+// Claims files one at a time until none remain
+static void* searchWorker(void* arg) {
+    SearchJob* job = arg;
+
+    for(;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if(i >= job->count)
+            break;
+
+        searchFile(&job->results[i], job->pattern, job->m);
+    }
+
+    return NULL;
+}
+
+
+// Persistent search threads
+// Started on first search and reused, so searches neither create threads
+// nor register new per-thread libFS counters
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work; // Signals a new job
+    pthread_cond_t idle; // Signals a worker finished its part of a job
+    SearchJob* job;
+    unsigned long generation; // Bumped for each job
+    size_t busy; // Workers yet to finish current job
+    size_t size; // Threads in pool
+} SearchPool;
+
+SearchPool pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, 0, 0, 0 };
+pthread_mutex_t search_lock = PTHREAD_MUTEX_INITIALIZER; // One search runs on the pool at a time
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+
+// Pool thread body
+// Works on each posted job once, then waits for the next
+static void* poolMain(void* arg) {
+    (void)arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool.lock);
+
+    for(;;) {
+        while(pool.generation == seen)
+            pthread_cond_wait(&pool.work, &pool.lock);
+
+        seen = pool.generation;
+        SearchJob* job = pool.job;
+
+        pthread_mutex_unlock(&pool.lock);
+        searchWorker(job);
+        pthread_mutex_lock(&pool.lock);
+
+        if(--pool.busy == 0)
+            pthread_cond_signal(&pool.idle);
+    }
+
+    return NULL;
+}
+
+
+// Starts one pool thread per core, less the calling thread which works too
+static void poolStart(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cores > 1 ? (size_t)cores - 1 : 0;
+    if(threads > SEARCH_MAX_THREADS - 1) threads = SEARCH_MAX_THREADS - 1;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    for(size_t i = 0; i < threads; i++) {
+        pthread_t thread;
+        if(pthread_create(&thread, &attr, poolMain, NULL) != 0)
+            break;
+        pool.size++;
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+
+// Runs 'job' on the pool and calling thread, returning once every file is searched
+static void poolRun(SearchJob* job) {
+    pthread_once(&pool_once, poolStart);
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = job;
+    pool.busy = pool.size;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    searchWorker(job);
+
+    // Job lives on caller's stack, wait until no worker still uses it
+    pthread_mutex_lock(&pool.lock);
+    while(pool.busy)
+        pthread_cond_wait(&pool.idle, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+
+// Orders results by file name
+static int cmpResult(const void* a, const void* b) {
+    return strcmp(((const SearchResult*)a)->filename, ((const SearchResult*)b)->filename);
+}
+
+
+// Searches every file for 'pattern' using one thread per core
+// Threads come from a pool kept between calls, concurrent calls run one at a time
+// Only files with matches or errors are returned, ordered by file name
+// Number of results written to 'num_results'
+// Caller must free returned array, NULL if no results or allocation fails
+SearchResult* searchFiles(const char* pattern, size_t* num_results) {
+    *num_results = 0;
+
+    size_t m = strlen(pattern);
+    if(m == 0) // Empty pattern matches nothing useful
+        return NULL;
+
+    // Copy names, workers open files themselves
+    size_t num_files = 0;
+    FileEntry** files = fileList(&num_files);
+    if(!files)
+        return NULL;
+
+    SearchResult* results = calloc(num_files ? num_files : 1, sizeof(SearchResult));
+    if(!results) {
+        free(files);
+        return NULL;
+    }
+
+    for(size_t i = 0; i < num_files; i++)
+        strcpy(results[i].filename, files[i]->filename);
+    free(files);
+
+    SearchJob job = { results, num_files, 0, pattern, m };
+
+    pthread_mutex_lock(&search_lock);
+    poolRun(&job);
+    pthread_mutex_unlock(&search_lock);
+
+    // Keep files worth reporting
+    size_t kept = 0;
+    for(size_t i = 0; i < num_files; i++) {
+        if(results[i].matches || results[i].error != LIBFS_OK)
+            results[kept++] = results[i];
+    }
+
+    if(kept == 0) {
+        free(results);
+        return NULL;
+    }
+
+    qsort(results, kept, sizeof(SearchResult), cmpResult);
+
+    *num_results = kept;
+    return results;
+}
@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/Alex_textbuf.h"
+
+
+#define TB_MIN_CAP 64 // Initial text capacity in bytes
+#define TB_MIN_LINES 16 // Initial line index capacity
+
+
+// Number of text bytes outside the gap
+#define TEXT_LEN(tb) ((tb)->cap - ((tb)->gap_end - (tb)->gap_start))
+
+
+// Creates empty buffer holding a single empty line
+// Returns zero on allocation failure
+int tbInit(TextBuf* tb) {
+    tb->text = malloc(TB_MIN_CAP);
+    tb->lines = malloc(TB_MIN_LINES * sizeof(size_t));
+
+    if(!tb->text || !tb->lines) {
+        free(tb->text);
+        free(tb->lines);
+        tb->text = NULL;
+        tb->lines = NULL;
+        return 0;
+    }
+
+    // Whole buffer is gap
+    tb->cap = TB_MIN_CAP;
+    tb->gap_start = 0;
+    tb->gap_end = TB_MIN_CAP;
+
+    // First line always starts at zero
+    tb->lcap = TB_MIN_LINES;
+    tb->lines[0] = 0;
+    tb->lgap_start = 1;
+    tb->lgap_end = TB_MIN_LINES;
+
+    return 1;
+}
+
+
+// Frees buffer memory
+void tbFree(TextBuf* tb) {
+    free(tb->text);
+    free(tb->lines);
+    memset(tb, 0, sizeof(*tb));
+}
+
+
+// Returns number of text bytes
+size_t tbLength(const TextBuf* tb) {
+    return TEXT_LEN(tb);
+}
+
+
+// Returns number of lines, one more than number of newlines
+size_t tbLineCount(const TextBuf* tb) {
+    return tb->lcap - (tb->lgap_end - tb->lgap_start);
+}
+
+
+// Returns position of first byte of line 'y'
+size_t tbLineStart(const TextBuf* tb, size_t y) {
+    if(y < tb->lgap_start) // Before gap, stored absolute
+        return tb->lines[y];
+
+    // After gap, stored as distance from end of text
+    return TEXT_LEN(tb) - tb->lines[y + (tb->lgap_end - tb->lgap_start)];
+}
+
+
+// Returns length of line 'y' excluding its newline
+size_t tbLineLength(const TextBuf* tb, size_t y) {
+    size_t end = y + 1 < tbLineCount(tb) ? tbLineStart(tb, y + 1) - 1 : TEXT_LEN(tb);
+    return end - tbLineStart(tb, y);
+}
+
+
+// Copies up to 'n' bytes starting at 'pos' into 'out'
+// Returns number of bytes copied
+size_t tbCopy(const TextBuf* tb, size_t pos, size_t n, char* out) {
+    size_t len = TEXT_LEN(tb);
+    if(pos >= len)
+        return 0;
+    if(n > len - pos)
+        n = len - pos;
+
+    size_t copied = 0;
+
+    // Part before gap
+    if(pos < tb->gap_start) {
+        size_t front = tb->gap_start - pos;
+        if(front > n)
+            front = n;
+
+        memcpy(out, tb->text + pos, front);
+        copied = front;
+        pos += front;
+    }
+
+    // Part after gap
+    if(copied < n)
+        memcpy(out + copied, tb->text + tb->gap_end + (pos - tb->gap_start), n - copied);
+
+    return n;
+}
+
+
+// Exposes text as the two contiguous runs either side of the gap
+// Pointers stay valid until the next edit
+void tbSegments(const TextBuf* tb, const char** a, size_t* a_len, const char** b, size_t* b_len) {
+    *a = tb->text;
+    *a_len = tb->gap_start;
+    *b = tb->text + tb->gap_end;
+    *b_len = tb->cap - tb->gap_end;
+}
+
+
+// Moves gap so it begins at text position 'pos'
+// Line entries crossing the gap are converted between absolute and end-relative
+static void moveGap(TextBuf* tb, size_t pos) {
+    size_t len = TEXT_LEN(tb);
+
+    if(pos < tb->gap_start) { // Shift bytes before gap to after it
+        size_t d = tb->gap_start - pos;
+        memmove(tb->text + tb->gap_end - d, tb->text + pos, d);
+        tb->gap_start -= d;
+        tb->gap_end -= d;
+
+        // Lines starting after new gap move behind line gap
+        while(tb->lgap_start > 1 && tb->lines[tb->lgap_start - 1] > pos) {
+            size_t start = tb->lines[--tb->lgap_start];
+            tb->lines[--tb->lgap_end] = len - start;
+        }
+    }
+    else if(pos > tb->gap_start) { // Shift bytes after gap to before it
+        size_t d = pos - tb->gap_start;
+        memmove(tb->text + tb->gap_start, tb->text + tb->gap_end, d);
+        tb->gap_start += d;
+        tb->gap_end += d;
+
+        // Lines starting at or before new gap move in front of line gap
+        while(tb->lgap_end < tb->lcap && len - tb->lines[tb->lgap_end] <= pos) {
+            size_t start = len - tb->lines[tb->lgap_end++];
+            tb->lines[tb->lgap_start++] = start;
+        }
+    }
+}
+
+
+// Ensures text gap holds at least 'n' bytes
+// Returns zero on allocation failure
+static int growText(TextBuf* tb, size_t n) {
+    if(tb->gap_end - tb->gap_start >= n)
+        return 1;
+
+    size_t len = TEXT_LEN(tb);
+    size_t new_cap = tb->cap * 2;
+    if(new_cap < len + n + TB_MIN_CAP)
+        new_cap = len + n + TB_MIN_CAP;
+
+    char* text = malloc(new_cap);
+    if(!text)
+        return 0;
+
+    // Keep gap at same position with new size
+    size_t back = tb->cap - tb->gap_end;
+    memcpy(text, tb->text, tb->gap_start);
+    memcpy(text + new_cap - back, tb->text + tb->gap_end, back);
+
+    free(tb->text);
+    tb->text = text;
+    tb->gap_end = new_cap - back;
+    tb->cap = new_cap;
+
+    return 1;
+}
+
+
+// Ensures line index gap holds at least 'n' entries
+// Returns zero on allocation failure
+static int growLines(TextBuf* tb, size_t n) {
+    if(tb->lgap_end - tb->lgap_start >= n)
+        return 1;
+
+    size_t count = tbLineCount(tb);
+    size_t new_cap = tb->lcap * 2;
+    if(new_cap < count + n + TB_MIN_LINES)
+        new_cap = count + n + TB_MIN_LINES;
+
+    size_t* lines = malloc(new_cap * sizeof(size_t));
+    if(!lines)
+        return 0;
+
+    size_t back = tb->lcap - tb->lgap_end;
+    memcpy(lines, tb->lines, tb->lgap_start * sizeof(size_t));
+    memcpy(lines + new_cap - back, tb->lines + tb->lgap_end, back * sizeof(size_t));
+
+    free(tb->lines);
+    tb->lines = lines;
+    tb->lgap_end = new_cap - back;
+    tb->lcap = new_cap;
+
+    return 1;
+}
+
+
+// Inserts 'n' bytes of 's' at position 'pos'
+// Returns zero on allocation failure, leaving text unchanged
+int tbInsert(TextBuf* tb, size_t pos, const char* s, size_t n) {
+    size_t len = TEXT_LEN(tb);
+    if(pos > len)
+        pos = len;
+
+    // Count new lines up front so failure leaves buffer intact
+    size_t newlines = 0;
+    for(const char* p = s; (p = memchr(p, '\n', s + n - p)); p++)
+        newlines++;
+
+    if(!growText(tb, n) || !growLines(tb, newlines))
+        return 0;
+
+    moveGap(tb, pos);
+    memcpy(tb->text + tb->gap_start, s, n);
+
+    // Lines begun by inserted newlines start before the gap
+    for(const char* p = s; (p = memchr(p, '\n', s + n - p)); p++)
+        tb->lines[tb->lgap_start++] = pos + (p - s) + 1;
+
+    tb->gap_start += n;
+    return 1;
+}
+
+
+// Deletes up to 'n' bytes starting at position 'pos'
+void tbDelete(TextBuf* tb, size_t pos, size_t n) {
+    size_t len = TEXT_LEN(tb);
+    if(pos >= len)
+        return;
+    if(n > len - pos)
+        n = len - pos;
+
+    moveGap(tb, pos);
+
+    // Each deleted newline removes the next line entry after the gap
+    const char* s = tb->text + tb->gap_end;
+    for(const char* p = s; (p = memchr(p, '\n', s + n - p)); p++)
+        tb->lgap_end++;
+
+    tb->gap_end += n;
+}
@@ -0,0 +1,226 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/Alex_undo.h"
+
+
+// Record layout in arena
+// Header followed by the inserted or deleted bytes
+typedef struct {
+    uint32_t op;
+    uint32_t y, x; // Position of first byte
+    uint32_t len;
+} UndoRec;
+
+#define REC(u, i) ((UndoRec*)((u)->arena + (u)->recs[i]))
+#define REC_BYTES(u, i) ((u)->arena + (u)->recs[i] + sizeof(UndoRec))
+
+// Memory held by records from index 'k' onward, counted against the cap
+#define USED_FROM(u, k) ((u)->len - (u)->recs[k] + ((u)->count - (k)) * sizeof(size_t))
+
+// Records start aligned so headers can be accessed in place
+#define ALIGN_UP(n) (((n) + _Alignof(UndoRec) - 1) & ~(size_t)(_Alignof(UndoRec) - 1))
+
+
+// Creates empty history with default cap
+void undoInit(UndoLog* u) {
+    memset(u, 0, sizeof(*u));
+    u->max_bytes = UNDO_MAX_BYTES;
+}
+
+
+// Frees history memory
+void undoFree(UndoLog* u) {
+    size_t max_bytes = u->max_bytes;
+
+    free(u->arena);
+    free(u->recs);
+    memset(u, 0, sizeof(*u));
+
+    u->max_bytes = max_bytes;
+}
+
+
+// Drops records before index 'k' in one pass
+static void dropOldest(UndoLog* u, size_t k) {
+    if(k == 0)
+        return;
+
+    size_t base = k < u->count ? u->recs[k] : u->len;
+
+    memmove(u->arena, u->arena + base, u->len - base);
+    u->len -= base;
+
+    for(size_t i = k; i < u->count; i++)
+        u->recs[i - k] = u->recs[i] - base;
+
+    u->count -= k;
+    u->cur = u->cur > k ? u->cur - k : 0;
+}
+
+
+// Trims oldest records once history exceeds its cap
+// Drops down to half the cap so trimming stays rare, latest record always kept
+static void enforceCap(UndoLog* u) {
+    if(u->count == 0 || USED_FROM(u, 0) <= u->max_bytes)
+        return;
+
+    size_t k = 0;
+    while(k + 1 < u->count && USED_FROM(u, k) > u->max_bytes / 2)
+        k++;
+
+    dropOldest(u, k);
+}
+
+
+// Changes history cap, trimming oldest records to fit
+void undoSetCap(UndoLog* u, size_t max_bytes) {
+    u->max_bytes = max_bytes;
+    enforceCap(u);
+}
+
+
+// Ensures arena holds 'n' more bytes and offsets one more record
+// Returns zero on allocation failure
+static int reserve(UndoLog* u, size_t n) {
+    if(u->len + n > u->cap) {
+        size_t cap = u->cap ? u->cap * 2 : 4096;
+        while(cap < u->len + n)
+            cap *= 2;
+
+        char* grown = realloc(u->arena, cap);
+        if(!grown)
+            return 0;
+
+        u->arena = grown;
+        u->cap = cap;
+    }
+
+    if(u->count == u->rcap) {
+        size_t rcap = u->rcap ? u->rcap * 2 : 64;
+
+        size_t* grown = realloc(u->recs, rcap * sizeof(size_t));
+        if(!grown)
+            return 0;
+
+        u->recs = grown;
+        u->rcap = rcap;
+    }
+
+    return 1;
+}
+
+
+// Tries to extend last record with an edit continuing it
+// Typing extends inserts at their end, backspacing extends deletes at their start
+// Returns non-zero if edit was absorbed
+static int coalesce(UndoLog* u, int op, size_t y, size_t x, const char* s, size_t n) {
+    if(!u->open || u->count == 0 || memchr(s, '\n', n))
+        return 0;
+
+    UndoRec* r = REC(u, u->count - 1);
+
+    if(r->op != (uint32_t)op || r->y != y || r->len + n > UNDO_RUN_MAX)
+        return 0;
+
+    if(op == UNDO_INSERT && x == r->x + r->len) { // Typed after run
+        if(!reserve(u, n))
+            return 0;
+
+        r = REC(u, u->count - 1);
+        memcpy(u->arena + u->len, s, n);
+    }
+    else if(op == UNDO_DELETE && x + n == r->x) { // Erased before run
+        if(!reserve(u, n))
+            return 0;
+
+        r = REC(u, u->count - 1);
+        char* bytes = REC_BYTES(u, u->count - 1);
+        memmove(bytes + n, bytes, r->len);
+        memcpy(bytes, s, n);
+        r->x = x;
+    }
+    else {
+        return 0;
+    }
+
+    r->len += n;
+    u->len += n;
+    return 1;
+}
+
+
+// Records an applied edit, 's' holds inserted or deleted bytes
+// Discards undone edits, they can no longer be redone
+// History is cleared if a single edit exceeds the cap
+void undoRecord(UndoLog* u, int op, size_t y, size_t x, const char* s, size_t n) {
+    if(n == 0)
+        return;
+
+    // New edit replaces redo history
+    if(u->cur < u->count) {
+        u->len = u->recs[u->cur];
+        u->count = u->cur;
+        u->open = 0;
+    }
+
+    if(!coalesce(u, op, y, x, s, n)) {
+        size_t start = ALIGN_UP(u->len);
+
+        if(sizeof(UndoRec) + n + sizeof(size_t) > u->max_bytes || !reserve(u, start - u->len + sizeof(UndoRec) + n)) {
+            undoFree(u); // Edit cannot be kept, older history would be inconsistent
+            return;
+        }
+
+        u->len = start;
+        UndoRec r = { op, y, x, n };
+        memcpy(u->arena + u->len, &r, sizeof(r));
+        memcpy(u->arena + u->len + sizeof(r), s, n);
+
+        u->recs[u->count++] = u->len;
+        u->len += sizeof(r) + n;
+    }
+
+    // Runs end at line breaks
+    u->open = !memchr(s, '\n', n);
+    u->cur = u->count;
+
+    enforceCap(u);
+}
+
+
+// Ends current run so next edit starts a new record
+// Called when cursor moves or an edit should undo on its own
+void undoBreak(UndoLog* u) {
+    u->open = 0;
+}
+
+
+// Reverts most recent applied edit through 'apply'
+// Returns zero if nothing to undo
+int undoStep(UndoLog* u, UndoApply apply) {
+    if(u->cur == 0)
+        return 0;
+
+    UndoRec* r = REC(u, --u->cur);
+    apply(r->op == UNDO_INSERT ? UNDO_DELETE : UNDO_INSERT, r->y, r->x, REC_BYTES(u, u->cur), r->len);
+
+    u->open = 0;
+    return 1;
+}
+
+
+// Reapplies most recently undone edit through 'apply'
+// Returns zero if nothing to redo
+int redoStep(UndoLog* u, UndoApply apply) {
+    if(u->cur == u->count)
+        return 0;
+
+    UndoRec* r = REC(u, u->cur);
+    apply(r->op, r->y, r->x, REC_BYTES(u, u->cur), r->len);
+
+    u->cur++;
+    u->open = 0;
+    return 1;
+}
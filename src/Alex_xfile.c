@@ -1,12 +1,14 @@
 #include <stdio.h>
 #include "../include/Alex_libFS2025.h"
 #include "../include/Alex_editor.h"
+#include "../include/Alex_libFSStats.h"
+#include "../include/Alex_search.h"
 
 
 #define INPUT_BUF_SIZE 64
 #define FILE_DATA_BUF_SIZE 2048
 
-#define EDITOR_USE_MSG "The file editor allows you to write text to file.\nQuit Without Saving:\t'ctrl+q'\nSave and Quit:\t'ctrl+x'\n\nPress enter key to enter the editor or any other key to return to menu\n"
+#define EDITOR_USE_MSG "The file editor allows you to write text to file.\nQuit Without Saving:\t'ctrl+q'\nSave and Quit:\t'ctrl+x'\nUndo / Redo:\t'ctrl+z' / 'ctrl+y'\nSearch:\t\t'ctrl+f'\n\nPress enter key to enter the editor or any other key to return to menu\n"
 
 
 // Reads input and assigns to buffer argument
@@ -23,6 +25,13 @@ char *get_input(char *buffer, size_t size) {
 }
 
 
+// Prints description of the calling thread's last libFS failure
+// 'name' identifies the file the failed call targeted
+void printError(const char *name) {
+    printf("Error: %s ('%s').\n", libfsStrerror(libfsLastError()), name);
+}
+
+
 // Function to display the menu
 void displayMenu() {
     printf("\n--- Menu ---\n");
@@ -31,7 +40,9 @@ void displayMenu() {
     printf("3. Read from a file\n");
     printf("4. List files\n");
     printf("5. Delete a file\n");
-    printf("6. Exit\n");
+    printf("6. Stats\n");
+    printf("7. Search files\n");
+    printf("8. Exit\n");
     printf("Enter your choice: ");
 }
 
@@ -46,7 +57,10 @@ void handleCreate() {
     if(!get_input(input, INPUT_BUF_SIZE)) // Check for read failure
         return;
 
-    fileCreate(input);
+    if(fileCreate(input) == LIBFS_ERR)
+        printError(input);
+    else
+        printf("File '%s' created successfully.\n", input);
 }
 
 
@@ -85,21 +99,25 @@ void handleRead() {
 
     int fd = fileOpen(file_name); // Open file
 
-    if(fd == LIBFS_ERR) // Error opening file
+    if(fd == LIBFS_ERR) { // Error opening file
+        printError(file_name);
         return;
+    }
     
     char file_data[FILE_DATA_BUF_SIZE]; // Data from file
 
-    // Read file data
-    int file_size = fileRead(fd, file_data, FILE_DATA_BUF_SIZE);
+    // Read file data, leaving room for terminator
+    int file_size = fileRead(fd, file_data, FILE_DATA_BUF_SIZE - 1);
 
     if(file_size == LIBFS_ERR) // Check for file read error
-        return;
-
-    file_data[file_size] = '\0';
-
-    if(file_size > 0) // Print file content
+        printError(file_name);
+    else if(file_size == 0) // Nothing to display
+        printf("File '%s' is empty, no data to read\n", file_name);
+    else { // Print file content
+        file_data[file_size] = '\0';
+        printf("%d bytes of data read from file '%s' successfully.\n", file_size, file_name);
         printf("File Content:\n\n%s", file_data);
+    }
 
     fileClose(fd);
 }
@@ -134,7 +152,78 @@ void handleDelete() {
     if(!get_input(file_name, INPUT_BUF_SIZE)) // Get filename to read
         return;
 
-    fileDelete(file_name); // Delete file
+    if(fileDelete(file_name) == LIBFS_ERR) // Delete file
+        printError(file_name);
+}
+
+
+// Prints per-operation counters and latency percentiles
+// Latencies shown in microseconds
+void handleStats() {
+    LibFSStats stats;
+    libfsStats(&stats);
+
+    printf("\n\n%-8s %10s %8s %14s %10s %10s %10s %10s\n",
+           "Op", "Calls", "Errors", "Bytes", "Avg (us)", "p50 (us)", "p99 (us)", "Max (us)");
+
+    for(int op = 0; op < LIBFS_OP_COUNT; op++) {
+        LibFSOpStats* s = &stats.ops[op];
+
+        double avg = s->calls ? (double)s->total_ns / s->calls : 0;
+        printf("%-8s %10llu %8llu %14llu %10.1f %10.1f %10.1f %10.1f\n",
+               libfsOpName(op),
+               (unsigned long long)s->calls,
+               (unsigned long long)s->errors,
+               (unsigned long long)s->bytes,
+               avg / 1000,
+               libfsStatsPercentile(s, 0.50) / 1000.0,
+               libfsStatsPercentile(s, 0.99) / 1000.0,
+               s->max_ns / 1000.0);
+    }
+}
+
+
+// Searches content of every file for text read from input
+// Prints first matches of each file with line and column, files in name order
+void handleSearch() {
+    // Prompt user to enter text to find
+    char pattern[INPUT_BUF_SIZE];
+    printf("Enter the text to search for: ");
+
+    if(!get_input(pattern, INPUT_BUF_SIZE)) // Get search text
+        return;
+
+    if(!pattern[0]) { // Nothing to find
+        printf("No search text entered.\n");
+        return;
+    }
+
+    size_t num_results = 0;
+    SearchResult* results = searchFiles(pattern, &num_results);
+
+    if(!num_results) { // No file matched
+        printf("No files contain '%s'.\n", pattern);
+        return;
+    }
+
+    for(size_t i = 0; i < num_results; i++) {
+        SearchResult* r = &results[i];
+
+        if(r->error != LIBFS_OK) { // File could not be searched
+            printf("Error: %s ('%s').\n", libfsStrerror(r->error), r->filename);
+            continue;
+        }
+
+        printf("\n%s: %zu match%s\n", r->filename, r->matches, r->matches == 1 ? "" : "es");
+
+        for(size_t h = 0; h < r->num_hits; h++)
+            printf("  %zu:%zu: %s\n", r->hits[h].line, r->hits[h].col, r->hits[h].text);
+
+        if(r->matches > r->num_hits) // More matches than shown
+            printf("  ...\n");
+    }
+
+    free(results);
 }
 
 
@@ -145,6 +234,11 @@ int main() {
     int choice; // Stores user selection
     int files_loaded = libFSLoad(); // Load file(s) from previous sessions
 
+    if(files_loaded == LIBFS_ERR) { // Continue with empty file system
+        printf("Error opening FS base directory: %s", libfsStrerror(libfsLastError()));
+        files_loaded = 0;
+    }
+
     // Display intro messages
     printf("\n\nWelcome to xfile file-editor and file-system simulator!");
     printf("\n%d files have been loaded from previous sessions", files_loaded);
@@ -170,7 +264,13 @@ int main() {
             case 5: // Handle file deletion
                 handleDelete();
                 break;
-            case 6: // Exit program
+            case 6: // Display libFS metrics
+                handleStats();
+                break;
+            case 7: // Search content of all files
+                handleSearch();
+                break;
+            case 8: // Exit program
                 exit(0);
                 break;
         }